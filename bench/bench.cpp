@@ -0,0 +1,215 @@
+#include "log4cpp/Category.hh"
+#include "log4cpp/Priority.hh"
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+#include "engine.hh"
+#include "kernel.hh"
+#include "batch.hh"
+
+/**
+ * Benchmark driver: runs the tabu search over a fixed instance set and 
+ * seed list and prints one JSON object per instance (see README.md).
+ */
+
+namespace po = boost::program_options;
+
+namespace {
+
+struct Instance{
+	unsigned int g;
+	unsigned int p;
+	unsigned int w;
+	double time_limit;
+};
+
+/* Outcome of one seed */
+struct Run{
+	bool solved;
+	double wall;
+	unsigned int iterations;
+	unsigned int restarts;
+};
+
+/**-------------------------------**/
+/* Lines "G P W TIME_LIMIT"; blank lines and '#' comments are skipped */
+std::vector<Instance> read_instances(std::istream& in)
+{
+	std::vector<Instance> instances;
+	std::string text;
+	for(unsigned int line = 1 ; std::getline(in, text) ; line++){
+		std::istringstream fields(text);
+		std::string first;
+		if(!(fields >> first) || first[0] == '#')
+			continue;
+		fields.clear();
+		fields.seekg(0);
+
+		Instance i;
+		std::string rest;
+		if(	!(fields >> i.g >> i.p >> i.w >> i.time_limit) || 
+			i.g == 0 || i.p == 0 || i.w == 0 || i.time_limit <= 0 ||
+			fields >> rest){
+			throw std::invalid_argument("line " + std::to_string(line) +
+										": expected G P W TIME_LIMIT");
+		}
+		instances.push_back(i);
+	}
+	return instances;
+}
+
+/**-------------------------------**/
+/**
+ * Nearest-rank percentile Q of the time to solution, unsolved runs
+ * counting as infinitely slow. Writes null when it falls on one.
+ */
+void percentile(std::ostream& os, const std::vector<Run>& runs, double q)
+{
+	std::vector<double> times;
+	for(const Run &r : runs){
+		times.push_back(r.solved ? 	r.wall : 
+									std::numeric_limits<double>::infinity());
+	}
+	std::sort(times.begin(), times.end());
+	unsigned int rank = static_cast<unsigned int>(q * times.size() + 0.999999);
+	rank = std::max(rank, 1u) - 1;
+	if(times[rank] == std::numeric_limits<double>::infinity())
+		os << "null";
+	else
+		os << times[rank];
+}
+
+} // NAMESPACE
+
+/**-------------------------------**/
+int main(int argc, char** argv)
+{
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help,h", "produce help message")
+		("instances",	po::value<std::string>()->default_value(
+											"bench/instances.txt"), 
+		 				"Instance file, lines \"G P W TIME_LIMIT\"")
+		("seeds",		po::value<unsigned int>()->default_value(10), 
+		 				"Runs per instance, seeded 1..SEEDS")
+		("tabu-list",	po::value<std::string>()->default_value("dotu"), 
+		 				"Tabu list implementation: dotu | flat")
+		("init",		po::value<std::string>()->default_value("random"), 
+		 				"Initial solutions: random | greedy")
+		("max-stable-tries", po::value<unsigned int>()->default_value(300), 
+		 				"Maximal stable tries for local search")
+		("min-tabu", 	po::value<unsigned int>()->default_value(4), 
+		 				"Minimum tabu iteration for elements")
+		("max-tabu", 	po::value<unsigned int>()->default_value(100), 
+		 				"Maximum tabu iteration for elements")
+		;
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return EXIT_SUCCESS;
+		}
+	} catch(const po::error &e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	sgp::TABU_LIST tabu_list = sgp::TABU_LIST::DOTU;
+	if(vm["tabu-list"].as<std::string>() == "flat"){
+		tabu_list = sgp::TABU_LIST::FLAT;
+	}else if(vm["tabu-list"].as<std::string>() != "dotu"){
+		std::cerr 	<< "Unknown tabu list: " 
+					<< vm["tabu-list"].as<std::string>() << std::endl;
+		return EXIT_FAILURE;
+	}
+	sgp::INIT_ALG init_alg = sgp::INIT_ALG::RANDOM;
+	if(vm["init"].as<std::string>() == "greedy"){
+		init_alg = sgp::INIT_ALG::GREEDY;
+	}else if(vm["init"].as<std::string>() != "random"){
+		std::cerr 	<< "Unknown initialization: " 
+					<< vm["init"].as<std::string>() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Instance> instances;
+	std::ifstream file(vm["instances"].as<std::string>());
+	if(!file){
+		std::cerr 	<< "Cannot open " << vm["instances"].as<std::string>() 
+					<< std::endl;
+		return EXIT_FAILURE;
+	}
+	try{
+		instances = read_instances(file);
+	}catch(const std::invalid_argument &e){
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	/* the search logs at INFO level, keep it out of the timings */
+	log4cpp::Category::getRoot().setPriority(log4cpp::Priority::ERROR);
+
+	const unsigned int seeds = vm["seeds"].as<unsigned int>();
+	for(const Instance &i : instances){
+		std::vector<Run> runs;
+		for(unsigned int seed = 1 ; seed <= seeds ; seed++){
+			/* the time limit ends the run, not the number of tries */
+			std::unique_ptr<sgp::SGPInstanceSolver> solver = 
+						sgp::make_tabu_solver(	tabu_list, i.g, i.p, i.w,
+								std::numeric_limits<int>::max(),
+								vm["max-stable-tries"].as<unsigned int>(),
+								vm["min-tabu"].as<unsigned int>(),
+								vm["max-tabu"].as<unsigned int>());
+			solver->set_init_alg(init_alg);
+			solver->seed(seed);
+			std::chrono::steady_clock::time_point start = 
+											std::chrono::steady_clock::now();
+			sgp::run_with_limit(*solver, i.time_limit);
+			Run run;
+			run.wall = std::chrono::duration<double>(
+						std::chrono::steady_clock::now() - start).count();
+			run.solved = solver->get_eval() == 0;
+			run.iterations = solver->iterations();
+			run.restarts = solver->restarts();
+			runs.push_back(run);
+		}
+
+		unsigned int solved = 0;
+		double wall = 0, iterations = 0, restarts = 0;
+		for(const Run &r : runs){
+			solved += r.solved;
+			wall += r.wall;
+			iterations += r.iterations;
+			restarts += r.restarts;
+		}
+		std::cout 	<< "{\"instance\": \"" << i.g << "-" << i.p << "-" << i.w 
+					<< "\", \"kernel\": \"" 
+					<< sgp::kernel::name(sgp::kernel::active())
+					<< "\", \"time_limit\": " << i.time_limit
+					<< ", \"runs\": " << runs.size()
+					<< ", \"solved\": " << solved
+					<< ", \"success_rate\": " 
+					<< (runs.empty() ? 0.0 : solved / double(runs.size()));
+		for(double q : {0.5, 0.9, 1.0}){
+			std::cout << ", \"time_p" << static_cast<int>(q * 100) << "\": ";
+			if(runs.empty())
+				std::cout << "null";
+			else
+				percentile(std::cout, runs, q);
+		}
+		std::cout 	<< ", \"iterations_per_sec\": " 
+					<< (wall > 0 ? iterations / wall : 0.0)
+					<< ", \"restarts_mean\": " 
+					<< (runs.empty() ? 0.0 : restarts / runs.size())
+					<< "}" << std::endl;
+	}
+	return EXIT_SUCCESS;
+}
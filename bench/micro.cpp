@@ -0,0 +1,224 @@
+#include "log4cpp/Category.hh"
+#include "log4cpp/Priority.hh"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "sgp.hh"
+#include "tabu.hh"
+
+/**
+ * Microbenchmarks of the hot-path primitives of BasicSGP and the Dotu
+ * tabu list. Every primitive runs on the same pre-generated states
+ * (a seeded random solution after some tabu search steps) and one JSON
+ * object per primitive and state reports ns/op and heap allocations/op.
+ * Built with -DBENCH, which makes SGPBench a friend of BasicSGP.
+ */
+
+namespace {
+
+/* heap allocations since the start, counted by the operators below */
+unsigned long allocations = 0;
+
+/* keeps the results of pure queries alive */
+volatile long sink = 0;
+
+/* minimal timed duration of every benchmark, in seconds */
+const double MIN_TIME = 0.2;
+
+} // NAMESPACE
+
+/**-------------------------------**/
+void* operator new(std::size_t size)
+{
+	allocations++;
+	if(void *ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+	throw std::bad_alloc();
+}
+/**-------------------------------**/
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+/**-------------------------------**/
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+/**-------------------------------**/
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+/**-------------------------------**/
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+/**-------------------------------**/
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+/**-------------------------------**/
+/**
+ * Repeats SETUP (untimed) and BODY, which performs OPS operations,
+ * until BODY has run for MIN_TIME and prints the averages per operation.
+ */
+template<class Setup, class Body>
+void measure(	const std::string& name, const std::string& state,
+				unsigned int ops, Setup setup, Body body)
+{
+	typedef std::chrono::steady_clock clock;
+	clock::duration elapsed(0);
+	unsigned long rounds = 0, allocated = 0;
+	while(std::chrono::duration<double>(elapsed).count() < MIN_TIME){
+		setup();
+		const unsigned long before = allocations;
+		clock::time_point start = clock::now();
+		body();
+		elapsed += clock::now() - start;
+		allocated += allocations - before;
+		rounds++;
+	}
+	const double total = static_cast<double>(rounds) * ops;
+	std::cout 	<< "{\"bench\": \"" << name << "\", \"state\": \"" << state
+				<< "\", \"ops\": " << static_cast<unsigned long>(total)
+				<< ", \"ns_per_op\": "
+				<< std::chrono::duration<double, std::nano>(elapsed).count() /
+																		total
+				<< ", \"allocs_per_op\": " << allocated / total
+				<< "}" << std::endl;
+}
+
+} // NAMESPACE
+
+namespace sgp{
+
+/**
+ * Reaches into BasicSGP for the primitives local_search is made of
+ */
+class SGPBench{
+
+  public:
+	/* Benchmarks every primitive on SGP, labelled STATE in the output */
+	template<class S>
+	static void run(S& sgp, const std::string& state);
+
+  private:
+	/* <W, GA, A> swapped with <W, GB, B> */
+	struct Swap{
+		unsigned int w;
+		unsigned int ga;
+		unsigned int a;
+		unsigned int gb;
+		unsigned int b;
+	};
+	static const unsigned int SAMPLES = 1024;
+	static const unsigned int STEPS = 256;
+};
+
+/**-------------------------------**/
+template<class S>
+void SGPBench::run(S& sgp, const std::string& state)
+{
+	/* the state: some way into a search, with a realistic conflict set */
+	SGPDotuTabuList tlist(sgp);
+	sgp.init_solution();
+	for(unsigned int i = 0 ; i < 1000 ; i++){
+		sgp.local_search(tlist, sgp.get_eval());
+		tlist.incr_iteration();
+	}
+	SGPSnapshot snap;
+	sgp.save(snap);
+
+	Random &rng = sgp.rng();
+	std::vector<Swap> swaps(SAMPLES);
+	for(Swap &s : swaps){
+		s.w = rng(sgp.w());
+		s.ga = rng(sgp.g());
+		s.gb = (s.ga + 1 + rng(sgp.g() - 1)) % sgp.g();
+		s.a = sgp.group_begin(s.w, s.ga)[rng(sgp.p())];
+		s.b = sgp.group_begin(s.w, s.gb)[rng(sgp.p())];
+	}
+	std::vector<ConflictSet::cell> cells;
+	for(unsigned int i = 0 ; i < sgp.conflict_set.size() && i < SAMPLES ; i++)
+		cells.push_back(sgp.conflict_set[i]);
+
+	auto none = [](){};
+	measure("set_field", state, 4 * SAMPLES, none, [&](){
+		for(const Swap &s : swaps){
+			sgp.set_field(s.w, s.ga, s.a, s.b);
+			sgp.set_field(s.w, s.gb, s.b, s.a);
+			sgp.set_field(s.w, s.ga, s.b, s.a);
+			sgp.set_field(s.w, s.gb, s.a, s.b);
+		}
+	});
+	measure("calc_conflicts_diff_in_group", state, SAMPLES, none, [&](){
+		long sum = 0;
+		for(const Swap &s : swaps)
+			sum += sgp.calc_conflicts_diff_in_group(s.w, s.ga, s.a, s.b);
+		sink = sum;
+	});
+	measure("calc_conflicts_player_in_group", state, SAMPLES, none, [&](){
+		long sum = 0;
+		for(const Swap &s : swaps)
+			sum += sgp.calc_conflicts_player_in_group(s.w, s.gb, s.a);
+		sink = sum;
+	});
+	if(!cells.empty()){
+		/* every cell is a member: removing then adding it back */
+		measure("remove_add_conflict", state, 2 * cells.size(), none, [&](){
+			for(const ConflictSet::cell &c : cells){
+				const unsigned int g = sgp._groups[c.w][c.player];
+				sgp.remove_conflict(c.w, g, c.player);
+				sgp.add_conflict(c.w, g, c.player);
+			}
+		});
+	}
+
+	SGPDotuTabuList bench_list(sgp);
+	measure("dotu_add", state, SAMPLES, [&](){ bench_list.clearAll(); },
+		[&](){
+			for(const Swap &s : swaps)
+				bench_list.add(s.w, s.a, s.b);
+		});
+	/* half of the queried pairs are tabu */
+	for(unsigned int i = 0 ; i < SAMPLES ; i += 2)
+		bench_list.add(swaps[i].w, swaps[i].a, swaps[i].b);
+	measure("dotu_is_tabu", state, SAMPLES, none, [&](){
+		long sum = 0;
+		for(const Swap &s : swaps)
+			sum += bench_list.is_tabu(s.w, s.b, s.a);
+		sink = sum;
+	});
+
+	measure("local_search", state, STEPS,
+		[&](){
+			sgp.restore(snap);
+			tlist.clearAll();
+		},
+		[&](){
+			for(unsigned int i = 0 ; i < STEPS ; i++){
+				sgp.local_search(tlist, snap.eval);
+				tlist.incr_iteration();
+			}
+		});
+}
+
+} // NAMESPACE_SGP
+
+/**-------------------------------**/
+int main()
+{
+	/* the search logs at INFO level, keep it out of the timings */
+	log4cpp::Category::getRoot().setPriority(log4cpp::Priority::ERROR);
+
+	/* instances a little past what local search solves in 1000 steps */
+	const unsigned int sizes[][3] = {{5, 3, 8}, {8, 4, 10}, {16, 8, 16}};
+	for(const auto &size : sizes){
+		sgp::SGP instance(size[0], size[1], size[2]);
+		instance.seed(1);
+		sgp::SGPBench::run(instance, 	std::to_string(size[0]) + "-" +
+										std::to_string(size[1]) + "-" +
+										std::to_string(size[2]));
+	}
+	sgp::FixedSGP<8, 4, 10> fixed(8, 4, 10);
+	fixed.seed(1);
+	sgp::SGPBench::run(fixed, "8-4-10 fixed");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+#include "batch.hh"
+#include "workers.hh"
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <mutex>
+
+/**-------------------------------**/
+bool sgp::run_with_limit(SGPInstanceSolver& solver, double limit)
+{
+	if(limit > 0)
+		solver.set_time_limit(limit);
+	solver.run();
+	return solver.stats().timed_out;
+}
+
+/**-------------------------------**/
+std::vector<sgp::BatchJob> sgp::read_batch(std::istream& in)
+{
+	std::vector<BatchJob> jobs;
+	std::string text;
+	for(unsigned int line = 1 ; std::getline(in, text) ; line++){
+		std::istringstream fields(text);
+		std::string first;
+		if(!(fields >> first) || first[0] == '#')
+			continue;
+		fields.clear();
+		fields.seekg(0);
+
+		long long g, p, w;
+		BatchJob job = {line, 0, 0, 0, false, 0, 0.0};
+		bool ok = static_cast<bool>(fields >> g >> p >> w) &&
+						g > 0 && p > 0 && w > 0 &&
+						g <= BATCH_MAX_PLAYERS && p <= BATCH_MAX_PLAYERS &&
+						g * p <= BATCH_MAX_PLAYERS && 
+						w <= BATCH_MAX_CELLS / (g * p);
+		if(ok){
+			job.g = g;
+			job.p = p;
+			job.w = w;
+			/* operator>> would take "-5" for an unsigned seed */
+			std::string seed;
+			if(fields >> seed){
+				ok = seed.find_first_not_of("0123456789") == std::string::npos;
+				try{
+					job.seed = ok ? std::stoull(seed) : 0;
+				}catch(const std::out_of_range&){
+					ok = false;
+				}
+				job.has_seed = true;
+				if(ok && fields >> job.time_limit)
+					ok = job.time_limit >= 0;
+			}
+			std::string rest;
+			fields.clear();
+			ok = ok && !(fields >> rest);
+		}
+		if(!ok){
+			throw std::invalid_argument("line " + std::to_string(line) +
+							": expected G P W [SEED] [TIME_LIMIT]");
+		}
+		jobs.push_back(job);
+	}
+	return jobs;
+}
+
+/**-------------------------------**/
+void sgp::run_batch(const std::vector<BatchJob>& jobs, unsigned int threads,
+					std::uint64_t seed, const SolverFactory& make,
+					std::ostream& out)
+{
+	std::mutex out_mutex;
+	out << "# line\tg\tp\tw\tseed\tstatus\teval\titerations\twall"
+		<< std::endl;
+
+	StealingPool pool(threads);
+	pool.run(jobs.size(), [&](unsigned int t, unsigned int){
+		const BatchJob &job = jobs[t];
+		const std::uint64_t job_seed =
+					job.has_seed ? job.seed : Random::derive(seed, job.line);
+		std::ostringstream record;
+		record 	<< job.line << '\t' << job.g << '\t' << job.p << '\t'
+				<< job.w << '\t' << job_seed << '\t';
+		try{
+			std::unique_ptr<SGPInstanceSolver> solver = make(job);
+			solver->seed(job_seed);
+			const bool timeout = run_with_limit(*solver, job.time_limit);
+			const int eval = solver->get_eval();
+			record 	<< (eval == 0 ? "solved" :
+						timeout ? "timeout" : "unsolved") << '\t'
+					<< eval << '\t' << solver->iterations() << '\t' 
+					<< solver->wall_time();
+		}catch(const std::exception &e){
+			record << "error\t" << e.what();
+		}
+
+		std::lock_guard<std::mutex> lock(out_mutex);
+		out << record.str() << std::endl;
+	});
+}
@@ -0,0 +1,68 @@
+#ifndef _BATCH_HH
+#define _BATCH_HH
+
+#include <vector>
+#include <memory>
+#include <istream>
+#include <ostream>
+#include <functional>
+#include <cstdint>
+#include "engine.hh"
+
+namespace sgp{
+
+/**
+ * One instance of a batch file line "G P W [SEED] [TIME_LIMIT]".
+ * TIME_LIMIT is in seconds of wall-clock time, 0 for none.
+ */
+struct BatchJob{
+	unsigned int line;
+	unsigned int g;
+	unsigned int p;
+	unsigned int w;
+	bool has_seed;
+	std::uint64_t seed;
+	double time_limit;
+};
+
+/**
+ * Largest instances of a batch file: G * P players (the greedy 
+ * construction needs fewer than 65536) and G * P * W cells
+ */
+const long long BATCH_MAX_PLAYERS = 65535;
+const long long BATCH_MAX_CELLS = 1ll << 24;
+
+/**
+ * Parses a batch file: one job per line, blank lines and lines starting
+ * with '#' are skipped. Throws std::invalid_argument naming the line of
+ * the first malformed job, including an instance over the bounds above
+ * or a negative seed.
+ */
+std::vector<BatchJob> read_batch(std::istream& in);
+
+/**
+ * Runs SOLVER with a limit of LIMIT seconds of wall-clock time 
+ * (LIMIT = 0: the limit SOLVER already has, if any). Returns true if
+ * the limit stopped the run.
+ */
+bool run_with_limit(SGPInstanceSolver& solver, double limit);
+
+typedef std::function<std::unique_ptr<SGPInstanceSolver>(const BatchJob&)>
+															SolverFactory;
+
+/**
+ * Solves JOBS on a StealingPool of THREADS threads, one solver (built
+ * by MAKE) per thread at a time. Jobs without a seed get stream LINE of
+ * SEED. As soon as a job finishes, one tab-separated record
+ *     line g p w seed status eval iterations wall
+ * is written to OUT (after a '#' header line), where STATUS is solved,
+ * unsolved, timeout or error; an error record carries the message in
+ * place of the numbers.
+ */
+void run_batch(	const std::vector<BatchJob>& jobs, unsigned int threads,
+				std::uint64_t seed, const SolverFactory& make,
+				std::ostream& out);
+
+} // NAMESPACE_SGP
+
+#endif //_BATCH_HH
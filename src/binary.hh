@@ -0,0 +1,56 @@
+#ifndef _BINARY_HH
+#define _BINARY_HH
+
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace sgp{
+
+/**
+ * Raw reads and writes of the checkpoint format. Values are stored as 
+ * they are in memory, so a checkpoint is only read back on a machine 
+ * of the same byte order. A short read throws std::invalid_argument.
+ */
+namespace binary{
+
+template<class T>
+inline void write(std::ostream& os, const T& value){
+	os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+inline void read(std::istream& is, T& value){
+	if(!is.read(reinterpret_cast<char*>(&value), sizeof(T)))
+		throw std::invalid_argument("truncated checkpoint");
+}
+
+/* The size (32 bits) followed by the elements */
+template<class T>
+inline void write_vector(std::ostream& os, const std::vector<T>& v){
+	write(os, static_cast<std::uint32_t>(v.size()));
+	if(!v.empty())
+		os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+/* Throws std::invalid_argument for more than MAX_SIZE elements */
+template<class T>
+inline void read_vector(std::istream& is, std::vector<T>& v, 
+						std::size_t max_size){
+	std::uint32_t size;
+	read(is, size);
+	if(size > max_size)
+		throw std::invalid_argument("corrupt checkpoint");
+	v.resize(size);
+	if(	size > 0 && 
+		!is.read(reinterpret_cast<char*>(v.data()), size * sizeof(T)))
+		throw std::invalid_argument("truncated checkpoint");
+}
+
+} // NAMESPACE_BINARY
+
+} // NAMESPACE_SGP
+
+#endif //_BINARY_HH
@@ -0,0 +1,74 @@
+#ifndef _BITS_HH
+#define _BITS_HH
+
+#include <cstdint>
+
+namespace sgp{
+
+/**
+ * Helpers for fixed-width bit rows stored as plain word arrays.
+ * A row of N bits occupies bits::words(N) consecutive words.
+ */
+namespace bits{
+
+typedef std::uint64_t word;
+
+const unsigned int WORD_BITS = 64;
+
+constexpr unsigned int words(unsigned int nbits)
+{
+	return (nbits + WORD_BITS - 1) / WORD_BITS;
+}
+
+inline void set(word* row, unsigned int i)
+{
+	row[i / WORD_BITS] |= word(1) << (i % WORD_BITS);
+}
+
+inline void reset(word* row, unsigned int i)
+{
+	row[i / WORD_BITS] &= ~(word(1) << (i % WORD_BITS));
+}
+
+inline bool test(const word* row, unsigned int i)
+{
+	return (row[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+}
+
+inline void clear(word* row, unsigned int nwords)
+{
+	for(unsigned int i = 0 ; i < nwords ; ++i)
+		row[i] = 0;
+}
+
+inline unsigned int count(const word* row, unsigned int nwords)
+{
+	unsigned int res = 0;
+	for(unsigned int i = 0 ; i < nwords ; ++i)
+		res += __builtin_popcountll(row[i]);
+	return res;
+}
+
+/* popcount(A & B) */
+inline unsigned int count_and(const word* a, const word* b, unsigned int nwords)
+{
+	unsigned int res = 0;
+	for(unsigned int i = 0 ; i < nwords ; ++i)
+		res += __builtin_popcountll(a[i] & b[i]);
+	return res;
+}
+
+/* (A & B) != 0 */
+inline bool intersects(const word* a, const word* b, unsigned int nwords)
+{
+	word res = 0;
+	for(unsigned int i = 0 ; i < nwords ; ++i)
+		res |= a[i] & b[i];
+	return res != 0;
+}
+
+} // NAMESPACE_BITS
+
+} // NAMESPACE_SGP
+
+#endif //_BITS_HH
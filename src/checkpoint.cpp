@@ -0,0 +1,172 @@
+#include "checkpoint.hh"
+#include "binary.hh"
+#include "tabu.hh"
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+
+namespace {
+
+const char MAGIC[8] = {'S', 'G', 'P', 'C', 'K', 'P', 'T', '\0'};
+const std::uint32_t VERSION = 2;
+
+const char* const INIT_NAMES[] = {"random", "greedy"};
+const char* const SYMMETRY_NAMES[] = {"none", "week", "group"};
+
+/**-------------------------------**/
+void write_snapshot(std::ostream& os, const sgp::SGPSnapshot& snap)
+{
+	sgp::binary::write_vector(os, snap.tables);
+	sgp::binary::write(os, static_cast<std::int32_t>(snap.eval));
+}
+
+/**-------------------------------**/
+void read_snapshot(std::istream& is, sgp::SGPSnapshot& snap, std::size_t n)
+{
+	std::int32_t eval;
+	sgp::binary::read_vector(is, snap.tables, n);
+	sgp::binary::read(is, eval);
+	if(snap.tables.size() != n)
+		throw std::invalid_argument("corrupt checkpoint");
+	snap.eval = eval;
+}
+
+/**-------------------------------**/
+/* The counters only: times are those of the process that measures them */
+void write_stats(std::ostream& os, const sgp::SearchStats& stats)
+{
+	using namespace sgp::binary;
+	write(os, stats.moves_evaluated);
+	write(os, stats.tabu_rejections);
+	write(os, stats.aspirations);
+	write(os, static_cast<std::uint32_t>(stats.restarts));
+	write(os, static_cast<std::uint32_t>(stats.iterations_to_best));
+	write(os, static_cast<std::int32_t>(stats.best_eval));
+	write(os, static_cast<std::uint64_t>(stats.peak_conflicts));
+	for(unsigned int m : stats.near_misses)
+		write(os, static_cast<std::uint32_t>(m));
+	write_vector(os, stats.milestones);
+}
+
+/**-------------------------------**/
+void read_stats(std::istream& is, sgp::SearchStats& stats)
+{
+	using namespace sgp::binary;
+	std::uint32_t u32;
+	std::int32_t i32;
+	std::uint64_t u64;
+	stats.clear();
+	read(is, stats.moves_evaluated);
+	read(is, stats.tabu_rejections);
+	read(is, stats.aspirations);
+	read(is, u32);
+	stats.restarts = u32;
+	read(is, u32);
+	stats.iterations_to_best = u32;
+	read(is, i32);
+	stats.best_eval = i32;
+	read(is, u64);
+	stats.peak_conflicts = u64;
+	for(unsigned int &m : stats.near_misses){
+		read(is, u32);
+		m = u32;
+	}
+	/* one milestone per improvement of the eval at most */
+	read_vector(is, stats.milestones, 1u << 24);
+}
+
+} // NAMESPACE
+
+/**-------------------------------**/
+bool sgp::write_checkpoint(	const std::string& path, 
+							const TabuCheckpoint& point,
+							const SGPTabuList& tabu)
+{
+	const std::string tmp = path + ".tmp";
+	{
+		std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+		if(!os)
+			return false;
+		os.write(MAGIC, sizeof(MAGIC));
+		binary::write(os, VERSION);
+		binary::write(os, static_cast<std::uint32_t>(point.g));
+		binary::write(os, static_cast<std::uint32_t>(point.p));
+		binary::write(os, static_cast<std::uint32_t>(point.w));
+		binary::write(os, static_cast<std::uint32_t>(point.init_alg));
+		binary::write(os, static_cast<std::uint32_t>(point.symmetry));
+		binary::write(os, static_cast<std::uint32_t>(point.max_stable));
+		binary::write(os, static_cast<std::uint32_t>(point.tries));
+		binary::write(os, static_cast<std::uint32_t>(point.stable_tries));
+		binary::write(os, static_cast<std::int32_t>(point.iter_best));
+		write_snapshot(os, point.current.solution);
+		binary::write_vector(os, point.current.conflicts);
+		binary::write(os, point.current.rng);
+		write_snapshot(os, point.best);
+		write_stats(os, point.stats);
+		tabu.save(os);
+		os.flush();
+		if(!os)
+			return false;
+	}
+	return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+/**-------------------------------**/
+void sgp::read_checkpoint(	const std::string& path, TabuCheckpoint& point,
+							SGPTabuList& tabu)
+{
+	std::ifstream is(path, std::ios::binary);
+	if(!is)
+		throw std::invalid_argument("cannot open " + path);
+
+	char magic[sizeof(MAGIC)];
+	std::uint32_t version, dims[3];
+	if(!is.read(magic, sizeof(magic)) || 
+		!std::equal(magic, magic + sizeof(magic), MAGIC))
+		throw std::invalid_argument(path + " is not a checkpoint");
+	binary::read(is, version);
+	if(version != VERSION)
+		throw std::invalid_argument(path + ": unsupported checkpoint version");
+	binary::read(is, dims);
+	if(dims[0] != point.g || dims[1] != point.p || dims[2] != point.w)
+		throw std::invalid_argument(path + ": checkpoint of another instance");
+
+	std::uint32_t init_alg, symmetry, max_stable;
+	binary::read(is, init_alg);
+	binary::read(is, symmetry);
+	binary::read(is, max_stable);
+	if(init_alg != static_cast<std::uint32_t>(point.init_alg)){
+		throw std::invalid_argument(path + ": checkpoint of a search with " 
+				"init " + (init_alg < 2 ? INIT_NAMES[init_alg] : "?"));
+	}
+	if(symmetry != static_cast<std::uint32_t>(point.symmetry)){
+		throw std::invalid_argument(path + ": checkpoint of a search with "
+				"symmetry " + (symmetry < 3 ? SYMMETRY_NAMES[symmetry] : "?"));
+	}
+	if(max_stable != point.max_stable){
+		throw std::invalid_argument(path + ": checkpoint of a search with "
+				"max stable tries " + std::to_string(max_stable));
+	}
+
+	const unsigned int g = point.g, p = point.p, w = point.w;
+	std::uint32_t u32;
+	std::int32_t i32;
+	binary::read(is, u32);
+	point.tries = u32;
+	binary::read(is, u32);
+	point.stable_tries = u32;
+	binary::read(is, i32);
+	point.iter_best = i32;
+	read_snapshot(is, point.current.solution, g * p * w);
+	binary::read_vector(is, point.current.conflicts, g * p * w);
+	binary::read(is, point.current.rng);
+	read_snapshot(is, point.best, g * p * w);
+	read_stats(is, point.stats);
+	try{
+		tabu.load(is);
+	}catch(const std::invalid_argument &e){
+		throw std::invalid_argument(path + ": " + e.what());
+	}
+}
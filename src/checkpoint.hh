@@ -0,0 +1,56 @@
+#ifndef _CHECKPOINT_HH
+#define _CHECKPOINT_HH
+
+#include <string>
+#include <cstdint>
+#include "sgp.hh"
+#include "stats.hh"
+
+namespace sgp{
+
+class SGPTabuList;
+
+/**
+ * State of a tabu search between two iterations, as saved in a 
+ * checkpoint file together with the tabu list
+ */
+struct TabuCheckpoint{
+	unsigned int g;
+	unsigned int p;
+	unsigned int w;
+	/* options the trajectory depends on, besides the tabu tenures */
+	INIT_ALG init_alg;
+	SYMMETRY symmetry;
+	unsigned int max_stable;
+	/* iterations done, and of those since the last improvement */
+	unsigned int tries;
+	unsigned int stable_tries;
+	/* best eval of the current search cycle */
+	int iter_best;
+	SGPState current;
+	SGPSnapshot best;
+	SearchStats stats;
+};
+
+/**
+ * Writes POINT and TABU to PATH in the binary format of binary.hh. 
+ * The file is written next to PATH and renamed over it, so PATH always
+ * holds a complete checkpoint. Returns false if it could not be written.
+ */
+bool write_checkpoint(	const std::string& path, const TabuCheckpoint& point,
+						const SGPTabuList& tabu);
+
+/**
+ * Reads the checkpoint at PATH into POINT and TABU. The instance and 
+ * options of POINT (g, p, w, init_alg, symmetry, max_stable) are those
+ * of the search to resume and are checked against the file. Throws 
+ * std::invalid_argument if PATH cannot be read, is not a checkpoint,
+ * or was written by a search of another instance, options or tabu list
+ * (kind or tenures); the message names the mismatch.
+ */
+void read_checkpoint(	const std::string& path, TabuCheckpoint& point, 
+						SGPTabuList& tabu);
+
+} // NAMESPACE_SGP
+
+#endif //_CHECKPOINT_HH
@@ -0,0 +1,70 @@
+#ifndef _CONFLICT_MATRIX_HH
+#define _CONFLICT_MATRIX_HH
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace sgp{
+
+/**
+ * Symmetric N x N matrix counting how often two players have met.
+ * All rows live in one contiguous block and each row is padded to a
+ * whole number of cache lines, so scanning the row of one player
+ * touches only ceil(N / 64) lines.
+ * Counts are bounded by the number of weeks and stored in one byte.
+ */
+class ConflictMatrix{
+
+  public:
+	typedef std::uint8_t count_type;
+
+	/* the largest count (and thus #weeks) a cell can hold */
+	static const unsigned int MAX_COUNT = UINT8_MAX;
+
+	explicit ConflictMatrix(unsigned int n)
+		: _n(n), _stride(padded(n)), _data(n * padded(n), 0)
+	{}
+
+	inline unsigned int size() const {	return _n;	}
+
+	inline count_type operator()(unsigned int p1, unsigned int p2) const{
+		return _data[p1 * _stride + p2];
+	}
+
+	/* Contiguous row of P1; entries [0, size()) are valid */
+	inline const count_type* row(unsigned int p1) const{
+		return &_data[p1 * _stride];
+	}
+
+	/* Increments both halves and returns the new count */
+	inline count_type inc(unsigned int p1, unsigned int p2){
+		++_data[p2 * _stride + p1];
+		return ++_data[p1 * _stride + p2];
+	}
+
+	/* Decrements both halves and returns the new count */
+	inline count_type dec(unsigned int p1, unsigned int p2){
+		--_data[p2 * _stride + p1];
+		return --_data[p1 * _stride + p2];
+	}
+
+	inline void clear(){
+		std::fill(_data.begin(), _data.end(), 0);
+	}
+
+  private:
+	static const unsigned int LINE = 64;
+
+	static unsigned int padded(unsigned int n){
+		return (n + LINE - 1) / LINE * LINE;
+	}
+
+	unsigned int _n;
+	unsigned int _stride;
+	std::vector<count_type> _data;
+};
+
+} // NAMESPACE_SGP
+
+#endif //_CONFLICT_MATRIX_HH
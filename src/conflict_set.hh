@@ -0,0 +1,107 @@
+#ifndef _CONFLICT_SET_HH
+#define _CONFLICT_SET_HH
+
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+namespace sgp{
+
+/**
+ * Set of conflicting cells <W, PLAYER>.
+ * Members are stored densely (erasing moves the last member into the
+ * hole) and a W x N position table maps every cell to its index, so
+ * insert, erase and lookup are O(1) and iteration is contiguous.
+ */
+class ConflictSet{
+
+  public:
+	struct cell{
+		unsigned int w;
+		unsigned int player;
+	};
+
+	typedef std::vector<cell>::const_iterator const_iterator;
+
+	ConflictSet(unsigned int w, unsigned int n)
+		: _n(n), _pos(w * n, NONE)
+	{
+		_cells.reserve(w * n);
+	}
+
+	/* Returns false if the cell was already a member */
+	inline bool insert(unsigned int w, unsigned int player){
+		int &pos = _pos[w * _n + player];
+		if(pos != NONE)
+			return false;
+		pos = static_cast<int>(_cells.size());
+		_cells.push_back(cell{w, player});
+		return true;
+	}
+
+	/* Returns false if the cell was not a member */
+	inline bool erase(unsigned int w, unsigned int player){
+		int &pos = _pos[w * _n + player];
+		if(pos == NONE)
+			return false;
+		const cell &last = _cells.back();
+		_pos[last.w * _n + last.player] = pos;
+		_cells[pos] = last;
+		_cells.pop_back();
+		pos = NONE;
+		return true;
+	}
+
+	inline bool contains(unsigned int w, unsigned int player) const{
+		return _pos[w * _n + player] != NONE;
+	}
+
+	inline std::size_t size() const {	return _cells.size();	}
+	inline bool empty() const {	return _cells.empty();	}
+
+	inline const cell& operator[](std::size_t i) const{
+		assert(i < _cells.size());
+		return _cells[i];
+	}
+
+	/**
+	 * Uniformly samples a member; DRAW(n) must return a value in [0, n).
+	 * PRE-CONDITION: the set is not empty
+	 */
+	template<class Draw>
+	inline const cell& sample(Draw&& draw) const{
+		assert(!_cells.empty());
+		return _cells[draw(static_cast<unsigned int>(_cells.size()))];
+	}
+
+	inline const_iterator begin() const {	return _cells.begin();	}
+	inline const_iterator end() const {	return _cells.end();	}
+
+	/**
+	 * Puts the members in the order of CELLS.
+	 * PRE-CONDITION: CELLS holds every member exactly once
+	 */
+	inline void reorder(const std::vector<cell>& cells){
+		assert(cells.size() == _cells.size());
+		_cells = cells;
+		for(std::size_t i = 0 ; i < _cells.size() ; i++)
+			_pos[_cells[i].w * _n + _cells[i].player] = static_cast<int>(i);
+	}
+
+	inline void clear(){
+		for(const cell &c : _cells)
+			_pos[c.w * _n + c.player] = NONE;
+		_cells.clear();
+	}
+
+  private:
+	enum { NONE = -1 };
+
+	unsigned int _n;
+	std::vector<int> _pos;
+	std::vector<cell> _cells;
+};
+
+} // NAMESPACE_SGP
+
+#endif //_CONFLICT_SET_HH
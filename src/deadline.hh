@@ -0,0 +1,55 @@
+#ifndef _DEADLINE_HH
+#define _DEADLINE_HH
+
+#include <chrono>
+
+namespace sgp{
+
+/**
+ * Wall-clock budget of a run on steady_clock. expired() reads the
+ * clock only every CHECK_INTERVAL calls, so it can be asked once per
+ * move of a search.
+ */
+class Deadline{
+
+  public:
+	typedef std::chrono::steady_clock clock;
+	static const unsigned int CHECK_INTERVAL = 16;
+
+	Deadline() : _limit(0), _calls(0), _expired(false) {}
+
+	/* Starts a budget of LIMIT seconds from now, LIMIT = 0: no budget */
+	void start(double limit){
+		_start = clock::now();
+		_limit = limit;
+		_calls = 0;
+		_expired = false;
+		if(limit > 0){
+			_end = _start + std::chrono::duration_cast<clock::duration>(
+									std::chrono::duration<double>(limit));
+		}
+	}
+
+	/* true once the budget is spent, up to CHECK_INTERVAL calls late */
+	inline bool expired(){
+		if(_limit > 0 && !_expired && ++_calls % CHECK_INTERVAL == 0)
+			_expired = clock::now() >= _end;
+		return _expired;
+	}
+
+	/* Wall-clock seconds since start() */
+	double elapsed() const{
+		return std::chrono::duration<double>(clock::now() - _start).count();
+	}
+
+  private:
+	clock::time_point _start;
+	clock::time_point _end;
+	double _limit;
+	unsigned int _calls;
+	bool _expired;
+};
+
+} // NAMESPACE_SGP
+
+#endif //_DEADLINE_HH
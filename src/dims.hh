@@ -0,0 +1,66 @@
+#ifndef _DIMS_HH
+#define _DIMS_HH
+
+#include <stdexcept>
+#include "bits.hh"
+
+namespace sgp{
+
+/**
+ * Size policies of BasicSGP, providing _g (#groups), _p (#players per 
+ * group), _w (#weeks) and _mask_words (words per bit row of g * p bits).
+ */
+
+/* Dimensions chosen at run time */
+class DynamicDims{
+
+  public:
+	static const bool FIXED = false;
+
+  protected:
+	DynamicDims(unsigned int g, unsigned int p, unsigned int w)
+		: _g(g), _p(p), _w(w), _mask_words(bits::words(g * p))
+	{}
+
+	unsigned int _g;
+	unsigned int _p;
+	unsigned int _w;
+	unsigned int _mask_words;
+};
+
+/**
+ * Dimensions fixed at compile time: every loop bound and index 
+ * computation of the engine folds into constants.
+ */
+template<unsigned int G, unsigned int P, unsigned int W>
+class FixedDims{
+
+  public:
+	static const bool FIXED = true;
+
+  protected:
+	FixedDims(unsigned int g, unsigned int p, unsigned int w)
+	{
+		if(g != G || p != P || w != W)
+			throw std::invalid_argument(
+						"instance does not match the fixed dimensions");
+	}
+
+	static constexpr unsigned int _g = G;
+	static constexpr unsigned int _p = P;
+	static constexpr unsigned int _w = W;
+	static constexpr unsigned int _mask_words = bits::words(G * P);
+};
+
+template<unsigned int G, unsigned int P, unsigned int W>
+constexpr unsigned int FixedDims<G, P, W>::_g;
+template<unsigned int G, unsigned int P, unsigned int W>
+constexpr unsigned int FixedDims<G, P, W>::_p;
+template<unsigned int G, unsigned int P, unsigned int W>
+constexpr unsigned int FixedDims<G, P, W>::_w;
+template<unsigned int G, unsigned int P, unsigned int W>
+constexpr unsigned int FixedDims<G, P, W>::_mask_words;
+
+} // NAMESPACE_SGP
+
+#endif //_DIMS_HH
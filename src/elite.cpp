@@ -0,0 +1,131 @@
+#include "elite.hh"
+#include <stdexcept>
+#include <algorithm>
+#include <climits>
+
+/**------------------------------------------------------------------------**/
+sgp::ElitePool::ElitePool(	unsigned int g, unsigned int p, unsigned int w,
+							unsigned int capacity, unsigned int min_distance)
+	: 	_g(g), _p(p), _w(w), _n(g * p),
+		_capacity(capacity),
+		_min_distance(min_distance),
+		_pair_words(bits::words(g * p * g * p))
+{
+	if(capacity == 0)
+		throw std::invalid_argument("elite pool without capacity");
+	_entries.reserve(capacity);
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::ElitePool::pairs_of(	const SGPSnapshot& snap, 
+								std::vector<bits::word>& pairs) const
+{
+	if(snap.tables.size() != _w * _n)
+		throw std::invalid_argument("snapshot of another instance");
+
+	pairs.assign(_pair_words, 0);
+	for(unsigned int grp = 0 ; grp < _w * _g ; grp++){
+		const int *members = &snap.tables[grp * _p];
+		for(unsigned int i = 0 ; i < _p ; i++){
+			for(unsigned int j = 0 ; j < i ; j++){
+				const unsigned int a = std::min(members[i], members[j]);
+				const unsigned int b = std::max(members[i], members[j]);
+				bits::set(pairs.data(), a * _n + b);
+			}
+		}
+	}
+}
+
+/**------------------------------------------------------------------------**/
+unsigned int sgp::ElitePool::distance(	const std::vector<bits::word>& a, 
+										const std::vector<bits::word>& b) const
+{
+	unsigned int res = 0;
+	for(unsigned int i = 0 ; i < _pair_words ; i++)
+		res += __builtin_popcountll(a[i] ^ b[i]);
+	return res;
+}
+
+/**------------------------------------------------------------------------**/
+unsigned int sgp::ElitePool::distance(	const SGPSnapshot& a, 
+										const SGPSnapshot& b) const
+{
+	std::vector<bits::word> pa, pb;
+	pairs_of(a, pa);
+	pairs_of(b, pb);
+	return distance(pa, pb);
+}
+
+/**------------------------------------------------------------------------**/
+bool sgp::ElitePool::offer(const SGPSnapshot& snap)
+{
+	entry cand;
+	pairs_of(snap, cand.pairs);		// outside the lock
+	cand.snap = snap;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	/* the closest member guards its neighbourhood */
+	unsigned int nearest = 0;
+	unsigned int nearest_dist = UINT_MAX;
+	for(unsigned int i = 0 ; i < _entries.size() ; i++){
+		const unsigned int d = distance(cand.pairs, _entries[i].pairs);
+		if(d < nearest_dist){
+			nearest_dist = d;
+			nearest = i;
+		}
+	}
+	if(nearest_dist < _min_distance){
+		if(snap.eval >= _entries[nearest].snap.eval)
+			return false;
+		_entries[nearest] = std::move(cand);
+		return true;
+	}
+
+	if(_entries.size() < _capacity){
+		_entries.push_back(std::move(cand));
+		return true;
+	}
+
+	unsigned int worst = 0;
+	for(unsigned int i = 1 ; i < _entries.size() ; i++){
+		if(_entries[i].snap.eval > _entries[worst].snap.eval)
+			worst = i;
+	}
+	if(snap.eval >= _entries[worst].snap.eval)
+		return false;
+	_entries[worst] = std::move(cand);
+	return true;
+}
+
+/**------------------------------------------------------------------------**/
+bool sgp::ElitePool::sample(Random& rng, SGPSnapshot& snap) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(_entries.empty())
+		return false;
+	const SGPSnapshot &src = _entries[rng(_entries.size())].snap;
+	snap.tables.assign(src.tables.begin(), src.tables.end());
+	snap.eval = src.eval;
+	return true;
+}
+
+/**------------------------------------------------------------------------**/
+unsigned int sgp::ElitePool::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.size();
+}
+
+/**------------------------------------------------------------------------**/
+unsigned int sgp::ElitePool::capacity() const {	return _capacity;	}
+
+/**------------------------------------------------------------------------**/
+int sgp::ElitePool::best_eval() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	int res = INT_MAX;
+	for(const entry &e : _entries)
+		res = std::min(res, e.snap.eval);
+	return res;
+}
@@ -0,0 +1,64 @@
+#ifndef _ELITE_HH
+#define _ELITE_HH
+
+#include <vector>
+#include <mutex>
+#include "sgp.hh"
+
+namespace sgp{
+
+/**
+ * Bounded pool of good solutions shared by cooperating solvers.
+ * Two solutions are compared by the pairs of players they let meet:
+ * their distance is the number of pairs that meet in exactly one of 
+ * them, which does not depend on how groups or weeks are labelled.
+ * A candidate closer than MIN_DISTANCE to a pool member (distance 
+ * < MIN_DISTANCE, so 0 turns this off) may only replace that member, 
+ * and only if it is better; otherwise it fills a free slot or replaces
+ * the worst member if it is better than it.
+ * All members are guarded by one mutex; offers and samples happen once
+ * per restart, far from the hot loop.
+ */
+class ElitePool{
+
+  public:
+	ElitePool(	unsigned int g, unsigned int p, unsigned int w,
+				unsigned int capacity, unsigned int min_distance);
+
+	/* Returns true if SNAP entered the pool */
+	bool offer(const SGPSnapshot& snap);
+
+	/* Copies a uniformly drawn member into SNAP; false if the pool is empty */
+	bool sample(Random& rng, SGPSnapshot& snap) const;
+
+	unsigned int size() const;
+	unsigned int capacity() const;
+	/* INT_MAX if the pool is empty */
+	int best_eval() const;
+
+	unsigned int distance(const SGPSnapshot& a, const SGPSnapshot& b) const;
+
+  private:
+	struct entry{
+		SGPSnapshot snap;
+		std::vector<bits::word> pairs;	/* bit A * N + B set iff A < B met */
+	};
+
+	unsigned int _g;
+	unsigned int _p;
+	unsigned int _w;
+	unsigned int _n;
+	unsigned int _capacity;
+	unsigned int _min_distance;
+	unsigned int _pair_words;
+	std::vector<entry> _entries;
+	mutable std::mutex _mutex;
+
+	void pairs_of(const SGPSnapshot& snap, std::vector<bits::word>& pairs) const;
+	unsigned int distance(	const std::vector<bits::word>& a, 
+							const std::vector<bits::word>& b) const;
+};
+
+} // NAMESPACE_SGP
+
+#endif //_ELITE_HH
@@ -0,0 +1,463 @@
+#include "engine.hh"
+#include "tabu.hh"
+#include "grasp.hh"
+#include "lns.hh"
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <exception>
+
+namespace {
+
+using sgp::ElitePool;
+
+/**
+ * Search of type SOLVER together with the instance of type S it solves.
+ * Forwards the SGPInstanceSolver interface to both; NAME is the search
+ * named by the errors of the features it rejects (elite pool, 
+ * checkpoints), which the searches that have them override.
+ */
+template<class S, class Solver>
+class OwningSolver : public sgp::SGPInstanceSolver{
+
+	public:
+		template<class... Args>
+		OwningSolver(	const char* name, 
+						unsigned int g, unsigned int p, unsigned int w,
+						Args... args)
+			: 	name(name),
+				instance(g, p, w),
+				solver(instance, args...)
+		{}
+
+		void run() { solver.run(); }
+		double runtime() { return solver.runtime(); }
+		double wall_time() { return solver.wall_time(); }
+		unsigned int iterations() { return solver.iterations(); }
+		unsigned int restarts() { return solver.restarts(); }
+		const sgp::SearchStats& stats() const { return solver.stats(); }
+		void seed(std::uint64_t seed) { solver.seed(seed); }
+		int get_eval() const { return instance.get_eval(); }
+		bool fixed() const { return S::FIXED; }
+		void print(std::ostream& os) const { os << instance; }
+		void set_cancel(const std::atomic<bool>* flag){ 
+			solver.set_cancel(flag); 
+		}
+		void set_time_limit(double seconds){ 
+			solver.set_time_limit(seconds); 
+		}
+		void set_elite_pool(ElitePool* pool, unsigned int){
+			if(pool != nullptr){
+				throw std::invalid_argument(
+							std::string(name) + " does not use an elite pool");
+			}
+		}
+		void set_checkpoint(const std::string&, unsigned int every){
+			if(every > 0){
+				throw std::invalid_argument(
+							std::string(name) + " does not write checkpoints");
+			}
+		}
+		void resume(const std::string&){
+			throw std::invalid_argument(
+							std::string(name) + " cannot resume a checkpoint");
+		}
+		void set_worker_pool(sgp::WorkerPool* pool){
+			instance.set_worker_pool(pool);
+		}
+		void set_init_alg(sgp::INIT_ALG alg){ instance.set_init_alg(alg); }
+		void set_symmetry(sgp::SYMMETRY mode){ instance.set_symmetry(mode); }
+
+	protected:
+		const char* name;
+		S instance;
+		Solver solver;
+};
+
+/**
+ * Tabu solver of type SOLVER<S> together with the instance it solves
+ */
+template<class S, template<class> class Solver>
+class OwningTabuSolver : public OwningSolver<S, Solver<S>>{
+
+	public:
+		OwningTabuSolver(	unsigned int g, unsigned int p, unsigned int w,
+							unsigned int max_tries, unsigned int max_stable,
+							unsigned int tabu_min, unsigned int tabu_max)
+			: 	OwningSolver<S, Solver<S>>(	"Tabu search", g, p, w, 
+											max_tries, max_stable, 
+											tabu_min, tabu_max)
+		{}
+
+		void set_elite_pool(ElitePool* pool, unsigned int perturbation){
+			this->solver.set_elite_pool(pool, perturbation);
+		}
+		void set_checkpoint(const std::string& path, unsigned int every){
+			this->solver.set_checkpoint(path, every);
+		}
+		void resume(const std::string& path){ this->solver.resume(path); }
+};
+
+template<class S>
+using OwningDotuSolver = OwningTabuSolver<S, sgp::BasicSGPDotuTabuSolver>;
+template<class S>
+using OwningFlatSolver = OwningTabuSolver<S, sgp::BasicSGPFlatTabuSolver>;
+
+/**
+ * GRASP solver together with the instance it solves
+ */
+template<class S>
+class OwningGraspSolver : public OwningSolver<S, sgp::BasicSGPGraspSolver<S>>{
+
+	public:
+		OwningGraspSolver(	unsigned int g, unsigned int p, unsigned int w,
+							unsigned int iterations, unsigned int steps,
+							unsigned int rcl,
+							unsigned int tabu_min, unsigned int tabu_max)
+			: 	OwningSolver<S, sgp::BasicSGPGraspSolver<S>>(	
+							"GRASP", g, p, w, 
+							iterations, steps, rcl, tabu_min, tabu_max)
+		{}
+
+		void set_init_alg(sgp::INIT_ALG alg){
+			if(alg != sgp::INIT_ALG::GREEDY)
+				throw std::invalid_argument("GRASP always builds greedily");
+		}
+};
+
+/**
+ * LNS solver together with the instance it solves
+ */
+template<class S>
+class OwningLnsSolver : public OwningSolver<S, sgp::BasicSGPLnsSolver<S>>{
+
+	public:
+		OwningLnsSolver(unsigned int g, unsigned int p, unsigned int w,
+						unsigned int iterations, unsigned int weeks,
+						unsigned long node_limit, unsigned int steps,
+						unsigned int tabu_min, unsigned int tabu_max)
+			: 	OwningSolver<S, sgp::BasicSGPLnsSolver<S>>(
+							"LNS", g, p, w, 
+							iterations, weeks, node_limit, steps, 
+							tabu_min, tabu_max)
+		{}
+};
+
+/**-------------------------------**/
+/**
+ * Builds OWNING<FixedSGP<G, P, W>> if <G, P, W> is one of the fixed
+ * instances and DYNAMIC is false, OWNING<SGP> otherwise; ARGS follow 
+ * the dimensions in its constructor.
+ */
+template<template<class> class Owning, class... Args>
+std::unique_ptr<sgp::SGPInstanceSolver> 
+make(	bool dynamic, unsigned int g, unsigned int p, unsigned int w,
+		Args... args)
+{
+#define SGP_MAKE_FIXED(G, P, W) 										\
+	if(g == G && p == P && w == W)										\
+		return std::unique_ptr<sgp::SGPInstanceSolver>(					\
+					new Owning<sgp::FixedSGP<G, P, W>>(g, p, w, args...));
+
+	if(!dynamic){
+		SGP_FIXED_INSTANCES(SGP_MAKE_FIXED)
+	}
+#undef SGP_MAKE_FIXED
+
+	return std::unique_ptr<sgp::SGPInstanceSolver>(
+										new Owning<sgp::SGP>(g, p, w, args...));
+}
+
+} // NAMESPACE
+
+/**-------------------------------**/
+std::unique_ptr<sgp::SGPInstanceSolver> 
+sgp::make_tabu_solver(	TABU_LIST list, 
+						unsigned int g, unsigned int p, unsigned int w,
+						unsigned int max_tries, unsigned int max_stable,
+						unsigned int tabu_min, unsigned int tabu_max,
+						bool dynamic)
+{
+	switch(list){
+		case TABU_LIST::DOTU:
+			return make<OwningDotuSolver>(	dynamic, g, p, w, max_tries, 
+											max_stable, tabu_min, tabu_max);
+		case TABU_LIST::FLAT:
+			return make<OwningFlatSolver>(	dynamic, g, p, w, max_tries, 
+											max_stable, tabu_min, tabu_max);
+	}
+	return nullptr;
+}
+
+/**-------------------------------**/
+std::unique_ptr<sgp::SGPParallelSolver> 
+sgp::make_parallel_tabu_solver(	unsigned int k, TABU_LIST list, 
+								unsigned int g, unsigned int p, unsigned int w,
+								unsigned int max_tries, 
+								unsigned int max_stable,
+								unsigned int tabu_min, unsigned int tabu_max,
+								bool dynamic)
+{
+	std::vector<std::unique_ptr<SGPInstanceSolver>> workers;
+	for(unsigned int i = 0 ; i < k ; i++){
+		workers.push_back(make_tabu_solver(	list, g, p, w, 
+											max_tries, max_stable,
+											tabu_min, tabu_max, dynamic));
+	}
+	return std::unique_ptr<SGPParallelSolver>(
+									new SGPParallelSolver(std::move(workers)));
+}
+
+/**-------------------------------**/
+std::unique_ptr<sgp::SGPInstanceSolver> 
+sgp::make_grasp_solver(	unsigned int g, unsigned int p, unsigned int w,
+						unsigned int iterations, unsigned int steps,
+						unsigned int rcl,
+						unsigned int tabu_min, unsigned int tabu_max,
+						bool dynamic)
+{
+	return make<OwningGraspSolver>(	dynamic, g, p, w, iterations, steps, 
+									rcl, tabu_min, tabu_max);
+}
+
+/**-------------------------------**/
+std::unique_ptr<sgp::SGPParallelSolver> 
+sgp::make_parallel_grasp_solver(unsigned int k,
+								unsigned int g, unsigned int p, unsigned int w,
+								unsigned int iterations, unsigned int steps,
+								unsigned int rcl,
+								unsigned int tabu_min, unsigned int tabu_max,
+								bool dynamic)
+{
+	std::vector<std::unique_ptr<SGPInstanceSolver>> workers;
+	for(unsigned int i = 0 ; i < k ; i++){
+		workers.push_back(make_grasp_solver(g, p, w, iterations, steps, rcl,
+											tabu_min, tabu_max, dynamic));
+	}
+	return std::unique_ptr<SGPParallelSolver>(
+									new SGPParallelSolver(std::move(workers)));
+}
+
+/**-------------------------------**/
+std::unique_ptr<sgp::SGPInstanceSolver> 
+sgp::make_lns_solver(	unsigned int g, unsigned int p, unsigned int w,
+						unsigned int iterations, unsigned int weeks,
+						unsigned long node_limit, unsigned int steps,
+						unsigned int tabu_min, unsigned int tabu_max,
+						bool dynamic)
+{
+	return make<OwningLnsSolver>(	dynamic, g, p, w, iterations, weeks, 
+									node_limit, steps, tabu_min, tabu_max);
+}
+
+/**-------------------------------**/
+std::unique_ptr<sgp::SGPParallelSolver> 
+sgp::make_parallel_lns_solver(	unsigned int k,
+								unsigned int g, unsigned int p, unsigned int w,
+								unsigned int iterations, unsigned int weeks,
+								unsigned long node_limit, unsigned int steps,
+								unsigned int tabu_min, unsigned int tabu_max,
+								bool dynamic)
+{
+	std::vector<std::unique_ptr<SGPInstanceSolver>> workers;
+	for(unsigned int i = 0 ; i < k ; i++){
+		workers.push_back(make_lns_solver(	g, p, w, iterations, weeks, 
+											node_limit, steps, 
+											tabu_min, tabu_max, dynamic));
+	}
+	return std::unique_ptr<SGPParallelSolver>(
+									new SGPParallelSolver(std::move(workers)));
+}
+
+/**================================**/
+/**=====  SGPParallelSolver =======**/
+/**================================**/
+sgp::SGPParallelSolver::SGPParallelSolver(
+					std::vector<std::unique_ptr<SGPInstanceSolver>> workers)
+	: 	_workers(std::move(workers)),
+		_cancel(nullptr),
+		_runtime(0),
+		_wall_time(0),
+		_iterations(0),
+		_restarts(0),
+		_winner(0),
+		_solved(false)
+{
+	if(_workers.empty())
+		throw std::invalid_argument("parallel solver without workers");
+}
+
+/**-------------------------------**/
+void sgp::SGPParallelSolver::run()
+{
+	std::atomic<bool> done(false);
+	std::atomic<int> first(-1);
+	std::atomic<unsigned int> finished(0);
+	/* a failing worker stops the race; its error is rethrown after it */
+	std::vector<std::exception_ptr> errors(_workers.size());
+
+	std::clock_t cpu_start = std::clock();
+	std::chrono::steady_clock::time_point start = 
+										std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	try{
+		for(unsigned int k = 0 ; k < _workers.size() ; k++){
+			_workers[k]->set_cancel(&done);
+			threads.emplace_back([&, k](){
+				try{
+					_workers[k]->run();
+					int none = -1;
+					if(	_workers[k]->get_eval() == 0 && 
+						first.compare_exchange_strong(none, 
+													static_cast<int>(k)))
+						done.store(true);
+				}catch(...){
+					errors[k] = std::current_exception();
+					done.store(true);
+				}
+				finished++;
+			});
+		}
+	}catch(...){
+		/* a thread that cannot start stops those already running */
+		done.store(true);
+		for(std::thread &t : threads)
+			t.join();
+		for(auto &w : _workers)
+			w->set_cancel(nullptr);
+		throw;
+	}
+
+	/* forward an outer cancellation to the workers */
+	if(_cancel != nullptr){
+		while(!done.load() && finished.load() < _workers.size()){
+			if(_cancel->load(std::memory_order_relaxed)){
+				done.store(true);
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	for(std::thread &t : threads)
+		t.join();
+
+	_wall_time = std::chrono::duration<double>(
+						std::chrono::steady_clock::now() - start).count();
+	_runtime = (std::clock() - cpu_start) / static_cast<double>(CLOCKS_PER_SEC);
+	_iterations = 0;
+	_restarts = 0;
+	for(auto &w : _workers){
+		_iterations += w->iterations();
+		_restarts += w->restarts();
+		w->set_cancel(nullptr);
+	}
+	for(const std::exception_ptr &e : errors){
+		if(e)
+			std::rethrow_exception(e);
+	}
+
+	_solved = first.load() != -1;
+	if(_solved){
+		_winner = first.load();
+	}else{
+		_winner = 0;
+		for(unsigned int k = 1 ; k < _workers.size() ; k++){
+			if(_workers[k]->get_eval() < _workers[_winner]->get_eval())
+				_winner = k;
+		}
+	}
+}
+
+/**-------------------------------**/
+double sgp::SGPParallelSolver::runtime(){ return _runtime; }
+/**-------------------------------**/
+double sgp::SGPParallelSolver::wall_time(){ return _wall_time; }
+/**-------------------------------**/
+unsigned int sgp::SGPParallelSolver::iterations(){ return _iterations; }
+/**-------------------------------**/
+unsigned int sgp::SGPParallelSolver::restarts(){ return _restarts; }
+/**-------------------------------**/
+const sgp::SearchStats& sgp::SGPParallelSolver::stats() const
+{
+	return _workers[_winner]->stats();
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::seed(std::uint64_t seed)
+{
+	for(unsigned int k = 0 ; k < _workers.size() ; k++)
+		_workers[k]->seed(Random::derive(seed, k));
+}
+/**-------------------------------**/
+int sgp::SGPParallelSolver::get_eval() const
+{
+	return _workers[_winner]->get_eval();
+}
+/**-------------------------------**/
+bool sgp::SGPParallelSolver::fixed() const
+{
+	return _workers[0]->fixed();
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::print(std::ostream& os) const
+{
+	_workers[_winner]->print(os);
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::set_cancel(const std::atomic<bool>* flag)
+{
+	_cancel = flag;
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::set_time_limit(double seconds)
+{
+	for(auto &w : _workers)
+		w->set_time_limit(seconds);
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::set_elite_pool(ElitePool* pool, 
+											unsigned int perturbation)
+{
+	for(auto &w : _workers)
+		w->set_elite_pool(pool, perturbation);
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::set_worker_pool(WorkerPool* pool)
+{
+	if(pool != nullptr)
+		throw std::invalid_argument(
+					"parallel workers cannot share a worker pool");
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::set_init_alg(INIT_ALG alg)
+{
+	for(auto &w : _workers)
+		w->set_init_alg(alg);
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::set_symmetry(SYMMETRY mode)
+{
+	for(auto &w : _workers)
+		w->set_symmetry(mode);
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::set_checkpoint(const std::string&, 
+											unsigned int every)
+{
+	if(every > 0)
+		throw std::invalid_argument("parallel workers cannot checkpoint");
+}
+/**-------------------------------**/
+void sgp::SGPParallelSolver::resume(const std::string&)
+{
+	throw std::invalid_argument("parallel workers cannot resume a checkpoint");
+}
+/**-------------------------------**/
+unsigned int sgp::SGPParallelSolver::workers() const
+{
+	return _workers.size();
+}
+/**-------------------------------**/
+unsigned int sgp::SGPParallelSolver::winner() const{ return _winner; }
+/**-------------------------------**/
+bool sgp::SGPParallelSolver::solved() const{ return _solved; }
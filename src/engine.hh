@@ -0,0 +1,205 @@
+#ifndef _ENGINE_HH
+#define _ENGINE_HH
+
+#include <memory>
+#include <ostream>
+#include <vector>
+#include <atomic>
+#include <string>
+#include "sgp.hh"
+#include "stats.hh"
+
+/**
+ * Instances <G, P, W> for which a FixedSGP<G, P, W> engine is compiled.
+ * X(G, P, W) is expanded once per instance; adding a line here is all 
+ * it takes to register another one.
+ */
+#define SGP_FIXED_INSTANCES(X) 	\
+	X(5, 3, 7)					\
+	X(8, 4, 9)					\
+	X(8, 4, 10)					\
+	X(10, 10, 3)
+
+namespace sgp{
+
+class ElitePool;
+
+enum class TABU_LIST {
+	DOTU,
+	FLAT
+};
+
+/**
+ * A solver that owns the instance it works on
+ */
+class SGPInstanceSolver : public SGPSolver{
+	public:
+		virtual int get_eval() const = 0;
+		/* true if the instance runs on a compile-time sized engine */
+		virtual bool fixed() const = 0;
+		virtual void print(std::ostream& os) const = 0;
+		/* see BasicSGPTabuSolver::set_cancel */
+		virtual void set_cancel(const std::atomic<bool>* flag) = 0;
+		/* see BasicSGPTabuSolver::set_time_limit */
+		virtual void set_time_limit(double seconds) = 0;
+		/* see BasicSGPTabuSolver::set_elite_pool */
+		virtual void set_elite_pool(ElitePool* pool, 
+									unsigned int perturbation) = 0;
+		/* see BasicSGP::set_worker_pool */
+		virtual void set_worker_pool(WorkerPool* pool) = 0;
+		/* Construction used by the first start and every restart */
+		virtual void set_init_alg(INIT_ALG alg) = 0;
+		/* see BasicSGP::set_symmetry */
+		virtual void set_symmetry(SYMMETRY mode) = 0;
+		/* Counters of the last run() */
+		virtual const SearchStats& stats() const = 0;
+		/**
+		 * see BasicSGPTabuSolver::set_checkpoint and resume; solvers
+		 * other than tabu search throw std::invalid_argument for any
+		 * checkpoint (EVERY > 0) and any resume.
+		 */
+		virtual void set_checkpoint(const std::string& path, 
+									unsigned int every) = 0;
+		virtual void resume(const std::string& path) = 0;
+};
+
+/**
+ * Runs independent solvers in parallel, one thread each, and stops all 
+ * of them as soon as one reaches a conflict-free schedule.
+ * Worker K is seeded with stream K of the seed, so a run is 
+ * reproducible up to which worker finishes first.
+ * The result is the solution of the winner (or, if none solved the 
+ * instance, of the worker with the lowest eval); iterations() and 
+ * restarts() sum all workers, runtime() is the CPU time of all of them
+ * and wall_time() the duration of the race.
+ * A worker that throws stops the race; run() rethrows its exception 
+ * (that of the lowest index if several throw) once all threads joined.
+ * So does a worker thread that cannot be started.
+ */
+class SGPParallelSolver : public SGPInstanceSolver{
+	public:
+		/* PRE-CONDITION: WORKERS is not empty */
+		explicit SGPParallelSolver(
+					std::vector<std::unique_ptr<SGPInstanceSolver>> workers);
+
+		void run();
+		double runtime();
+		double wall_time();
+		unsigned int iterations();
+		unsigned int restarts();
+		void seed(std::uint64_t seed);
+		int get_eval() const;
+		bool fixed() const;
+		void print(std::ostream& os) const;
+		void set_cancel(const std::atomic<bool>* flag);
+		/* Every worker gets the limit */
+		void set_time_limit(double seconds);
+		/* All workers cooperate through POOL */
+		void set_elite_pool(ElitePool* pool, unsigned int perturbation);
+		/**
+		 * Throws std::invalid_argument for a pool: the workers already 
+		 * run in parallel and cannot share one.
+		 */
+		void set_worker_pool(WorkerPool* pool);
+		void set_init_alg(INIT_ALG alg);
+		void set_symmetry(SYMMETRY mode);
+		/* Counters of the reported worker */
+		const SearchStats& stats() const;
+		/**
+		 * Throw std::invalid_argument for a checkpoint: the race has no
+		 * single search to save.
+		 */
+		void set_checkpoint(const std::string& path, unsigned int every);
+		void resume(const std::string& path);
+
+		unsigned int workers() const;
+		/* Index of the reported worker */
+		unsigned int winner() const;
+		/* true if the winner solved the instance */
+		bool solved() const;
+
+	private:
+		std::vector<std::unique_ptr<SGPInstanceSolver>> _workers;
+		const std::atomic<bool>* _cancel;
+		double _runtime;
+		double _wall_time;
+		unsigned int _iterations;
+		unsigned int _restarts;
+		unsigned int _winner;
+		bool _solved;
+};
+
+/**
+ * Builds a tabu solver with LIST over a fresh <G, P, W> instance.
+ * Uses the FixedSGP<G, P, W> engine when the instance is listed in
+ * SGP_FIXED_INSTANCES (unless DYNAMIC is set) and SGP otherwise.
+ */
+std::unique_ptr<SGPInstanceSolver> 
+make_tabu_solver(	TABU_LIST list, 
+					unsigned int g, unsigned int p, unsigned int w,
+					unsigned int max_tries, unsigned int max_stable,
+					unsigned int tabu_min, unsigned int tabu_max,
+					bool dynamic = false);
+
+/**
+ * K solvers as make_tabu_solver() builds them, raced in parallel
+ */
+std::unique_ptr<SGPParallelSolver> 
+make_parallel_tabu_solver(	unsigned int k, TABU_LIST list, 
+							unsigned int g, unsigned int p, unsigned int w,
+							unsigned int max_tries, unsigned int max_stable,
+							unsigned int tabu_min, unsigned int tabu_max,
+							bool dynamic = false);
+
+/**
+ * Builds a GRASP solver (see BasicSGPGraspSolver) over a fresh 
+ * <G, P, W> instance, choosing the engine as make_tabu_solver() does.
+ * The solver builds its own solutions and cannot use an elite pool: 
+ * set_elite_pool and set_init_alg throw std::invalid_argument for 
+ * anything but nullptr (resp. INIT_ALG::GREEDY).
+ */
+std::unique_ptr<SGPInstanceSolver> 
+make_grasp_solver(	unsigned int g, unsigned int p, unsigned int w,
+					unsigned int iterations, unsigned int steps,
+					unsigned int rcl,
+					unsigned int tabu_min, unsigned int tabu_max,
+					bool dynamic = false);
+
+/**
+ * K solvers as make_grasp_solver() builds them, each running its own 
+ * GRASP iterations in parallel
+ */
+std::unique_ptr<SGPParallelSolver> 
+make_parallel_grasp_solver(	unsigned int k,
+							unsigned int g, unsigned int p, unsigned int w,
+							unsigned int iterations, unsigned int steps,
+							unsigned int rcl,
+							unsigned int tabu_min, unsigned int tabu_max,
+							bool dynamic = false);
+
+/**
+ * Builds an LNS solver (see BasicSGPLnsSolver) over a fresh <G, P, W>
+ * instance, choosing the engine as make_tabu_solver() does.
+ * set_elite_pool throws std::invalid_argument for anything but nullptr.
+ */
+std::unique_ptr<SGPInstanceSolver> 
+make_lns_solver(unsigned int g, unsigned int p, unsigned int w,
+				unsigned int iterations, unsigned int weeks,
+				unsigned long node_limit, unsigned int steps,
+				unsigned int tabu_min, unsigned int tabu_max,
+				bool dynamic = false);
+
+/**
+ * K solvers as make_lns_solver() builds them, raced in parallel
+ */
+std::unique_ptr<SGPParallelSolver> 
+make_parallel_lns_solver(	unsigned int k,
+							unsigned int g, unsigned int p, unsigned int w,
+							unsigned int iterations, unsigned int weeks,
+							unsigned long node_limit, unsigned int steps,
+							unsigned int tabu_min, unsigned int tabu_max,
+							bool dynamic = false);
+
+} // NAMESPACE_SGP
+
+#endif //_ENGINE_HH
@@ -0,0 +1,133 @@
+#include "grasp.hh"
+#include "engine.hh"
+#include <ctime>
+#include <log4cpp/Category.hh>
+
+static log4cpp::Category& logger( log4cpp::Category::getInstance("grasp"));
+
+/**================================**/
+/**=====  SGPGraspSolver  =========**/
+/**================================**/
+template<class S>
+sgp::BasicSGPGraspSolver<S>::BasicSGPGraspSolver(	S& sgp,
+											unsigned int max_iterations,
+											unsigned int steps,
+											unsigned int rcl,
+											unsigned int tabu_min,
+											unsigned int tabu_max)
+	: 	sgp(sgp),
+		tlist(sgp, tabu_min, tabu_max),
+		runtime_(0),
+		wall_time_(0),
+		time_limit(0),
+		iterations_(0),
+		max_iterations(max_iterations),
+		steps(steps),
+		rcl(rcl),
+		cancel(nullptr)
+{}
+
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPGraspSolver<S>::run(void)
+{
+	std::clock_t start = std::clock(); /* START TIME */
+	deadline.start(time_limit);
+	stats_.clear();
+	sgp.set_stats(&stats_);
+
+	SGPSnapshot best;
+	unsigned int it = 0;
+	for( ; it < max_iterations && best.eval != 0 ; it++){
+		if(cancel != nullptr && cancel->load(std::memory_order_relaxed)){
+			SGP_INFO(logger, "Cancelled after %u iterations", it);
+			break;
+		}
+		if(deadline.expired()){
+			SGP_INFO(logger, "Time limit reached after %u iterations", it);
+			stats_.timed_out = true;
+			break;
+		}
+
+		const double construct_start = deadline.elapsed();
+		sgp.construct(rcl);
+		stats_.restart_seconds += deadline.elapsed() - construct_start;
+		tlist.clearAll();
+		if(sgp.get_eval() < best.eval){
+			sgp.save(best);
+			stats_.milestone(it + 1, best.eval, deadline.elapsed());
+		}
+
+		int cycle_best = sgp.get_eval();
+		for(unsigned int s = 0 ; 
+				s < steps && best.eval != 0 && !deadline.expired() ; s++){
+			sgp.local_search(tlist, best.eval);
+			tlist.incr_iteration();
+			cycle_best = std::min(cycle_best, sgp.get_eval());
+			if(sgp.get_eval() < best.eval){
+				sgp.save(best);
+				stats_.milestone(it + 1, best.eval, deadline.elapsed());
+				SGP_INFO(logger, "New best sgp (%d) found in iteration %u",
+															best.eval, it);
+			}
+		}
+		if(cycle_best >= 1 && cycle_best <= 3)
+			stats_.near_misses[cycle_best - 1]++;
+	}
+
+	this->runtime_ = 	(std::clock() - start ) /
+						static_cast<double>(CLOCKS_PER_SEC);
+	this->iterations_ = it;
+	stats_.iterations = it;
+	stats_.restarts = it > 0 ? it - 1 : 0;
+	this->wall_time_ = deadline.elapsed();
+	stats_.search_seconds = wall_time_ - stats_.restart_seconds;
+	sgp.set_stats(nullptr);
+	if(!best.tables.empty())
+		sgp.restore(best);
+}
+
+/**-------------------------------**/
+template<class S>
+double sgp::BasicSGPGraspSolver<S>::runtime(){ return runtime_; }
+/**-------------------------------**/
+template<class S>
+double sgp::BasicSGPGraspSolver<S>::wall_time(){ return wall_time_; }
+/**-------------------------------**/
+template<class S>
+unsigned int sgp::BasicSGPGraspSolver<S>::iterations(){ return iterations_; }
+/**-------------------------------**/
+template<class S>
+unsigned int sgp::BasicSGPGraspSolver<S>::restarts(){ return stats_.restarts; }
+/**-------------------------------**/
+template<class S>
+const sgp::SearchStats& sgp::BasicSGPGraspSolver<S>::stats() const
+{
+	return stats_;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPGraspSolver<S>::seed(std::uint64_t seed)
+{
+	sgp.seed(Random::derive(seed, 0));
+	tlist.seed(Random::derive(seed, 1));
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPGraspSolver<S>::set_cancel(const std::atomic<bool>* flag)
+{
+	cancel = flag;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPGraspSolver<S>::set_time_limit(double seconds)
+{
+	time_limit = seconds;
+}
+
+/**-------------------------------**/
+#define SGP_INSTANTIATE(G, P, W) 										\
+	template class sgp::BasicSGPGraspSolver<sgp::FixedSGP<G, P, W>>;
+
+template class sgp::BasicSGPGraspSolver<sgp::SGP>;
+SGP_FIXED_INSTANCES(SGP_INSTANTIATE)
@@ -0,0 +1,66 @@
+#ifndef _GRASP_HH
+#define _GRASP_HH
+
+#include <atomic>
+#include "sgp.hh"
+#include "tabu.hh"
+#include "stats.hh"
+#include "deadline.hh"
+
+namespace sgp{
+
+/**
+ * GRASP (greedy randomized adaptive search procedure) for SGP.
+ * Every iteration builds a solution with the randomized greedy
+ * heuristic (BasicSGP::construct with a restricted candidate list of
+ * RCL players) and improves it by at most STEPS moves of local_search
+ * on a fresh tabu list. The best solution over all iterations is kept.
+ * iterations() counts constructions, not moves.
+ */
+template<class S>
+class BasicSGPGraspSolver : public SGPSolver
+{
+	private:
+		S& sgp;
+		SGPFlatTabuList tlist;
+		double runtime_;
+		double wall_time_;
+		double time_limit;
+		Deadline deadline;
+		unsigned int iterations_;
+		SearchStats stats_;
+		unsigned int max_iterations;
+		unsigned int steps;
+		unsigned int rcl;
+		const std::atomic<bool>* cancel;
+
+	public:
+		BasicSGPGraspSolver(S& sgp, unsigned int max_iterations,
+									unsigned int steps,
+									unsigned int rcl,
+									unsigned int tabu_min,
+									unsigned int tabu_max);
+		void run(void);
+		double runtime();
+		double wall_time();
+		unsigned int iterations();
+		/* Constructions after the first one */
+		unsigned int restarts();
+		/**
+		 * Counters of the last run(); constructions count as restarts 
+		 * and every construction starts a search cycle.
+		 */
+		const SearchStats& stats() const;
+		/* Seeds the instance and the tabu list with derived streams */
+		void seed(std::uint64_t seed);
+		/* see BasicSGPTabuSolver::set_cancel */
+		void set_cancel(const std::atomic<bool>* flag);
+		/* see BasicSGPTabuSolver::set_time_limit */
+		void set_time_limit(double seconds);
+};
+
+typedef BasicSGPGraspSolver<SGP> SGPGraspSolver;
+
+} // NAMESPACE_SGP
+
+#endif //_GRASP_HH
@@ -0,0 +1,403 @@
+#include <climits>
+#include <stdexcept>
+
+#include "kernel.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SGP_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using sgp::MoveChoice;
+using sgp::SwapRows;
+using sgp::kernel::ISA;
+
+typedef MoveChoice (*best_moves_fn)(const int*, const int*, unsigned int);
+typedef void (*score_swaps_fn)(	const SwapRows&, const int*, unsigned int,
+								int*);
+
+/**------------------------------------------------------------------------**/
+/* Scans [BEGIN, END) on top of RES; strict comparison keeps the lowest index */
+inline MoveChoice scan_scalar(	const int* diff, const int* tabu,
+								unsigned int begin, unsigned int end,
+								MoveChoice res)
+{
+	for(unsigned int i = begin ; i < end ; ++i){
+		if(tabu[i]){
+			if(diff[i] < res.tabu_diff){
+				res.tabu_diff = diff[i];
+				res.tabu_idx = i;
+			}
+		}else if(diff[i] < res.free_diff){
+			res.free_diff = diff[i];
+			res.free_idx = i;
+		}
+	}
+	return res;
+}
+
+/**------------------------------------------------------------------------**/
+/* Folds the per-lane minima of a vector kernel into one choice */
+inline MoveChoice reduce_lanes(	const int* free_v, const int* free_i,
+								const int* tabu_v, const int* tabu_i,
+								unsigned int lanes)
+{
+	MoveChoice res = {INT_MAX, -1, INT_MAX, -1};
+	for(unsigned int l = 0 ; l < lanes ; ++l){
+		if(free_i[l] != -1 &&
+			(free_v[l] < res.free_diff ||
+			(free_v[l] == res.free_diff && free_i[l] < res.free_idx))){
+			res.free_diff = free_v[l];
+			res.free_idx = free_i[l];
+		}
+		if(tabu_i[l] != -1 &&
+			(tabu_v[l] < res.tabu_diff ||
+			(tabu_v[l] == res.tabu_diff && tabu_i[l] < res.tabu_idx))){
+			res.tabu_diff = tabu_v[l];
+			res.tabu_idx = tabu_i[l];
+		}
+	}
+	return res;
+}
+
+/**------------------------------------------------------------------------**/
+MoveChoice best_moves_scalar(const int* diff, const int* tabu, unsigned int n)
+{
+	MoveChoice res = {INT_MAX, -1, INT_MAX, -1};
+	return scan_scalar(diff, tabu, 0, n, res);
+}
+
+/**------------------------------------------------------------------------**/
+/* Scores the candidates [BEGIN, END) one by one */
+inline void score_range(const SwapRows& r, const int* b, 
+						unsigned int begin, unsigned int end, int* diff)
+{
+	const unsigned short *met_ga = r.met + r.ga * r.n;
+	const int base = -static_cast<int>(r.twice[r.ga * r.n + r.a]);
+	for(unsigned int k = begin ; k < end ; ++k){
+		const unsigned int x = b[k];
+		const unsigned int gx = r.group_of[x];
+		diff[k] = 	base + met_ga[x] + r.met[gx * r.n + r.a] - 
+					r.twice[gx * r.n + x] - 
+					2 * static_cast<int>((r.once[x / 64] >> (x % 64)) & 1);
+	}
+}
+
+/**------------------------------------------------------------------------**/
+void score_swaps_scalar(const SwapRows& rows, const int* b, unsigned int count,
+						int* diff)
+{
+	score_range(rows, b, 0, count, diff);
+}
+
+#ifdef SGP_KERNEL_X86
+
+/**------------------------------------------------------------------------**/
+__attribute__((target("sse4.2")))
+MoveChoice best_moves_sse42(const int* diff, const int* tabu, unsigned int n)
+{
+	const __m128i inf = _mm_set1_epi32(INT_MAX);
+	const __m128i step = _mm_set1_epi32(4);
+	__m128i free_v = inf, free_i = _mm_set1_epi32(-1);
+	__m128i tabu_v = inf, tabu_i = _mm_set1_epi32(-1);
+	__m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+
+	unsigned int i = 0;
+	for( ; i + 4 <= n ; i += 4){
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(diff + i));
+		__m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tabu + i));
+		__m128i df = _mm_blendv_epi8(d, inf, t);
+		__m128i dt = _mm_blendv_epi8(inf, d, t);
+
+		__m128i lf = _mm_cmpgt_epi32(free_v, df);
+		free_v = _mm_blendv_epi8(free_v, df, lf);
+		free_i = _mm_blendv_epi8(free_i, idx, lf);
+
+		__m128i lt = _mm_cmpgt_epi32(tabu_v, dt);
+		tabu_v = _mm_blendv_epi8(tabu_v, dt, lt);
+		tabu_i = _mm_blendv_epi8(tabu_i, idx, lt);
+
+		idx = _mm_add_epi32(idx, step);
+	}
+
+	int fv[4], fi[4], tv[4], ti[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(fv), free_v);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(fi), free_i);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(tv), tabu_v);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(ti), tabu_i);
+	return scan_scalar(diff, tabu, i, n, reduce_lanes(fv, fi, tv, ti, 4));
+}
+
+/**------------------------------------------------------------------------**/
+__attribute__((target("avx2")))
+MoveChoice best_moves_avx2(const int* diff, const int* tabu, unsigned int n)
+{
+	const __m256i inf = _mm256_set1_epi32(INT_MAX);
+	const __m256i step = _mm256_set1_epi32(8);
+	__m256i free_v = inf, free_i = _mm256_set1_epi32(-1);
+	__m256i tabu_v = inf, tabu_i = _mm256_set1_epi32(-1);
+	__m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+	unsigned int i = 0;
+	for( ; i + 8 <= n ; i += 8){
+		__m256i d = _mm256_loadu_si256(
+							reinterpret_cast<const __m256i*>(diff + i));
+		__m256i t = _mm256_loadu_si256(
+							reinterpret_cast<const __m256i*>(tabu + i));
+		__m256i df = _mm256_blendv_epi8(d, inf, t);
+		__m256i dt = _mm256_blendv_epi8(inf, d, t);
+
+		__m256i lf = _mm256_cmpgt_epi32(free_v, df);
+		free_v = _mm256_blendv_epi8(free_v, df, lf);
+		free_i = _mm256_blendv_epi8(free_i, idx, lf);
+
+		__m256i lt = _mm256_cmpgt_epi32(tabu_v, dt);
+		tabu_v = _mm256_blendv_epi8(tabu_v, dt, lt);
+		tabu_i = _mm256_blendv_epi8(tabu_i, idx, lt);
+
+		idx = _mm256_add_epi32(idx, step);
+	}
+
+	int fv[8], fi[8], tv[8], ti[8];
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(fv), free_v);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(fi), free_i);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(tv), tabu_v);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(ti), tabu_i);
+	return scan_scalar(diff, tabu, i, n, reduce_lanes(fv, fi, tv, ti, 8));
+}
+
+/**------------------------------------------------------------------------**/
+/* Counts are 16 bits: every gather reads 32 bits at 2 * index, masked */
+__attribute__((target("avx2")))
+void score_swaps_avx2(	const SwapRows& r, const int* b, unsigned int count,
+						int* diff)
+{
+	const int *met = reinterpret_cast<const int*>(r.met);
+	const int *met_ga = reinterpret_cast<const int*>(r.met + r.ga * r.n);
+	const int *twice = reinterpret_cast<const int*>(r.twice);
+	const int *once = reinterpret_cast<const int*>(r.once);
+	const __m256i low = _mm256_set1_epi32(0xffff);
+	const __m256i n = _mm256_set1_epi32(r.n);
+	const __m256i a = _mm256_set1_epi32(r.a);
+	const __m256i base = _mm256_set1_epi32(-r.twice[r.ga * r.n + r.a]);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i bit = _mm256_set1_epi32(31);
+
+	unsigned int i = 0;
+	for( ; i + 8 <= count ; i += 8){
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+		__m256i row = _mm256_mullo_epi32(
+							_mm256_i32gather_epi32(r.group_of, x, 4), n);
+		__m256i d = _mm256_and_si256(_mm256_i32gather_epi32(met_ga, x, 2), low);
+		d = _mm256_add_epi32(d, _mm256_and_si256(low, 
+				_mm256_i32gather_epi32(met, _mm256_add_epi32(row, a), 2)));
+		d = _mm256_sub_epi32(d, _mm256_and_si256(low, 
+				_mm256_i32gather_epi32(twice, _mm256_add_epi32(row, x), 2)));
+		__m256i met_once = _mm256_and_si256(one, _mm256_srlv_epi32(
+				_mm256_i32gather_epi32(once, _mm256_srli_epi32(x, 5), 4),
+				_mm256_and_si256(x, bit)));
+		d = _mm256_sub_epi32(	_mm256_add_epi32(d, base), 
+								_mm256_slli_epi32(met_once, 1));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(diff + i), d);
+	}
+	score_range(r, b, i, count, diff);
+}
+
+/**------------------------------------------------------------------------**/
+__attribute__((target("avx512f")))
+MoveChoice best_moves_avx512(const int* diff, const int* tabu, unsigned int n)
+{
+	const __m512i inf = _mm512_set1_epi32(INT_MAX);
+	const __m512i step = _mm512_set1_epi32(16);
+	__m512i free_v = inf, free_i = _mm512_set1_epi32(-1);
+	__m512i tabu_v = inf, tabu_i = _mm512_set1_epi32(-1);
+	__m512i idx = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+									8, 9, 10, 11, 12, 13, 14, 15);
+
+	unsigned int i = 0;
+	for( ; i + 16 <= n ; i += 16){
+		__m512i d = _mm512_loadu_si512(diff + i);
+		__m512i t = _mm512_loadu_si512(tabu + i);
+		__mmask16 tm = _mm512_test_epi32_mask(t, t);
+		__m512i df = _mm512_mask_blend_epi32(tm, d, inf);
+		__m512i dt = _mm512_mask_blend_epi32(tm, inf, d);
+
+		__mmask16 lf = _mm512_cmplt_epi32_mask(df, free_v);
+		free_v = _mm512_mask_blend_epi32(lf, free_v, df);
+		free_i = _mm512_mask_blend_epi32(lf, free_i, idx);
+
+		__mmask16 lt = _mm512_cmplt_epi32_mask(dt, tabu_v);
+		tabu_v = _mm512_mask_blend_epi32(lt, tabu_v, dt);
+		tabu_i = _mm512_mask_blend_epi32(lt, tabu_i, idx);
+
+		idx = _mm512_add_epi32(idx, step);
+	}
+
+	int fv[16], fi[16], tv[16], ti[16];
+	_mm512_storeu_si512(fv, free_v);
+	_mm512_storeu_si512(fi, free_i);
+	_mm512_storeu_si512(tv, tabu_v);
+	_mm512_storeu_si512(ti, tabu_i);
+	return scan_scalar(diff, tabu, i, n, reduce_lanes(fv, fi, tv, ti, 16));
+}
+
+/**------------------------------------------------------------------------**/
+/* see score_swaps_avx2 */
+__attribute__((target("avx512f")))
+void score_swaps_avx512(const SwapRows& r, const int* b, unsigned int count,
+						int* diff)
+{
+	const unsigned short *met_ga = r.met + r.ga * r.n;
+	const __m512i low = _mm512_set1_epi32(0xffff);
+	const __m512i n = _mm512_set1_epi32(r.n);
+	const __m512i a = _mm512_set1_epi32(r.a);
+	const __m512i base = _mm512_set1_epi32(-r.twice[r.ga * r.n + r.a]);
+	const __m512i one = _mm512_set1_epi32(1);
+	const __m512i bit = _mm512_set1_epi32(31);
+	const __m512i zero = _mm512_setzero_si512();
+	/* the masked forms: the plain ones trip -Wmaybe-uninitialized in GCC */
+	const __mmask16 all = 0xffff;
+
+	unsigned int i = 0;
+	for( ; i + 16 <= count ; i += 16){
+		__m512i x = _mm512_loadu_si512(b + i);
+		__m512i row = _mm512_mullo_epi32(
+							_mm512_mask_i32gather_epi32(zero, all, x, r.group_of, 4), n);
+		__m512i d = _mm512_and_si512(_mm512_mask_i32gather_epi32(zero, all, x, met_ga, 2), low);
+		d = _mm512_add_epi32(d, _mm512_and_si512(low, 
+				_mm512_mask_i32gather_epi32(zero, all, 
+										_mm512_add_epi32(row, a), r.met, 2)));
+		d = _mm512_sub_epi32(d, _mm512_and_si512(low, 
+				_mm512_mask_i32gather_epi32(zero, all, 
+										_mm512_add_epi32(row, x), r.twice, 2)));
+		__m512i met_once = _mm512_and_si512(one, _mm512_maskz_srlv_epi32(all,
+				_mm512_mask_i32gather_epi32(zero, all, 
+							_mm512_maskz_srli_epi32(all, x, 5), r.once, 4),
+				_mm512_and_si512(x, bit)));
+		d = _mm512_sub_epi32(	_mm512_add_epi32(d, base), 
+								_mm512_add_epi32(met_once, met_once));
+		_mm512_storeu_si512(diff + i, d);
+	}
+	score_range(r, b, i, count, diff);
+}
+
+#endif // SGP_KERNEL_X86
+
+/**------------------------------------------------------------------------**/
+bool supported(ISA isa)
+{
+	switch(isa){
+		case ISA::SCALAR:
+			return true;
+#ifdef SGP_KERNEL_X86
+		case ISA::SSE42:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse4.2");
+		case ISA::AVX2:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+		case ISA::AVX512:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx512f");
+#endif
+		default:
+			return false;
+	}
+}
+
+/**------------------------------------------------------------------------**/
+best_moves_fn impl_of(ISA isa)
+{
+	switch(isa){
+#ifdef SGP_KERNEL_X86
+		case ISA::SSE42:
+			return best_moves_sse42;
+		case ISA::AVX2:
+			return best_moves_avx2;
+		case ISA::AVX512:
+			return best_moves_avx512;
+#endif
+		default:
+			return best_moves_scalar;
+	}
+}
+
+/**------------------------------------------------------------------------**/
+score_swaps_fn score_impl_of(ISA isa)
+{
+	switch(isa){
+#ifdef SGP_KERNEL_X86
+		case ISA::AVX2:
+			return score_swaps_avx2;
+		case ISA::AVX512:
+			return score_swaps_avx512;
+#endif
+		default:
+			return score_swaps_scalar;
+	}
+}
+
+ISA active_isa = sgp::kernel::detect();
+best_moves_fn active_impl = impl_of(active_isa);
+score_swaps_fn active_score = score_impl_of(active_isa);
+
+} // NAMESPACE
+
+/**------------------------------------------------------------------------**/
+sgp::kernel::ISA sgp::kernel::detect()
+{
+	if(supported(ISA::AVX512))
+		return ISA::AVX512;
+	if(supported(ISA::AVX2))
+		return ISA::AVX2;
+	if(supported(ISA::SSE42))
+		return ISA::SSE42;
+	return ISA::SCALAR;
+}
+
+/**------------------------------------------------------------------------**/
+sgp::kernel::ISA sgp::kernel::active()
+{
+	return active_isa;
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::kernel::select(ISA isa)
+{
+	if(!supported(isa))
+		throw std::domain_error("instruction set not supported by this CPU");
+	active_isa = isa;
+	active_impl = impl_of(isa);
+	active_score = score_impl_of(isa);
+}
+
+/**------------------------------------------------------------------------**/
+const char* sgp::kernel::name(ISA isa)
+{
+	switch(isa){
+		case ISA::SSE42:
+			return "sse4.2";
+		case ISA::AVX2:
+			return "avx2";
+		case ISA::AVX512:
+			return "avx512";
+		default:
+			return "scalar";
+	}
+}
+
+/**------------------------------------------------------------------------**/
+sgp::MoveChoice sgp::kernel::best_moves(	const int* diff, const int* tabu,
+										unsigned int n)
+{
+	return active_impl(diff, tabu, n);
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::kernel::score_swaps(	const SwapRows& rows, const int* b, 
+								unsigned int count, int* diff)
+{
+	active_score(rows, b, count, diff);
+}
@@ -0,0 +1,113 @@
+#ifndef _KERNEL_HH
+#define _KERNEL_HH
+
+#include <vector>
+#include <cstdint>
+
+namespace sgp{
+
+/**
+ * A batch of candidate swaps, stored as structure of arrays.
+ * DIFF is the conflict difference of the swap, TABU is -1 for tabu
+ * moves and 0 otherwise; CELL and PLAYER identify the move for the caller.
+ * The first size() entries are in use; the arrays only ever grow, so
+ * a reused batch is filled in place without allocating or zeroing.
+ */
+struct MoveBatch{
+	std::vector<int> diff;
+	std::vector<int> tabu;
+	std::vector<unsigned int> cell;
+	std::vector<int> player;
+
+	inline unsigned int size() const { return used; }
+
+	inline void clear(){ used = 0; }
+
+	/* Makes room for N more candidates, returns the index of the first */
+	inline unsigned int grow(unsigned int n){
+		const unsigned int at = used;
+		used += n;
+		if(diff.size() < used){
+			diff.resize(used);
+			tabu.resize(used);
+			cell.resize(used);
+			player.resize(used);
+		}
+		return at;
+	}
+
+  private:
+	unsigned int used = 0;
+};
+
+/**
+ * The gain tables of one week seen from the swapping player A of group
+ * GA (see BasicSGP::calc_swap_diff). MET and TWICE point at the G rows
+ * of N counts of the week; the vector kernels read them with 32-bit 
+ * gathers, so one more count must be readable after the last row.
+ * ONCE is the met-once bit row of A, GROUP_OF the group of every player.
+ */
+struct SwapRows{
+	const unsigned short* met;
+	const unsigned short* twice;
+	const std::uint64_t* once;
+	const int* group_of;
+	unsigned int n;
+	unsigned int a;
+	unsigned int ga;
+};
+
+/**
+ * Best tabu and non-tabu candidates of a batch.
+ * An index of -1 means the batch holds no candidate of that kind.
+ */
+struct MoveChoice{
+	int tabu_diff;
+	int tabu_idx;
+	int free_diff;
+	int free_idx;
+};
+
+namespace kernel{
+
+enum class ISA {
+	SCALAR,
+	SSE42,
+	AVX2,
+	AVX512
+};
+
+/* Best instruction set supported by the running CPU */
+ISA detect();
+
+/* Instruction set used by best_moves() and score_swaps() */
+ISA active();
+
+/**
+ * Forces best_moves() and score_swaps() to use ISA.
+ * Throws std::domain_error if the running CPU does not support it.
+ */
+void select(ISA isa);
+
+const char* name(ISA isa);
+
+/**
+ * Scans the N candidates in one pass and returns the best tabu and
+ * the best non-tabu move; ties are broken by the lowest index.
+ */
+MoveChoice best_moves(const int* diff, const int* tabu, unsigned int n);
+
+/**
+ * Writes to DIFF[K] the conflict difference of swapping A with the 
+ * player B[K] of another group of the week, for K < COUNT.
+ * Lanes gather their counts from ROWS; SSE4.2 has no gathers and 
+ * scores with the scalar code.
+ */
+void score_swaps(	const SwapRows& rows, const int* b, unsigned int count,
+					int* diff);
+
+} // NAMESPACE_KERNEL
+
+} // NAMESPACE_SGP
+
+#endif //_KERNEL_HH
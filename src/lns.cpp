@@ -0,0 +1,300 @@
+#include "lns.hh"
+#include "engine.hh"
+#include <ctime>
+#include <algorithm>
+#include <log4cpp/Category.hh>
+
+static log4cpp::Category& logger( log4cpp::Category::getInstance("lns"));
+
+/**================================**/
+/**=====  WeekRepair  =============**/
+/**================================**/
+sgp::WeekRepair::WeekRepair(unsigned int g, unsigned int p)
+	: 	_g(g),
+		_p(p),
+		_n(g * p),
+		_nw(bits::words(g * p)),
+		_met(nullptr),
+		_rng(nullptr),
+		_node_limit(0),
+		_nodes(0),
+		_best_cost(0),
+		_found(false),
+		_cur(g * p),
+		_best(g * p),
+		_unplaced(bits::words(g * p)),
+		_members(g * bits::words(g * p)),
+		_keys(g * p * g * p)
+{}
+
+/**-------------------------------**/
+bool sgp::WeekRepair::search(	const std::vector<bits::word>& met,
+								unsigned int bound,
+								unsigned long node_limit, Random& rng,
+								const int* prefix, unsigned int prefix_size)
+{
+	if(met.size() != _n * _nw)
+		throw std::invalid_argument("meeting rows of another instance");
+
+	_met = met.data();
+	_rng = &rng;
+	_node_limit = node_limit;
+	_nodes = 0;
+	_best_cost = bound;
+	_found = false;
+	bits::clear(_unplaced.data(), _nw);
+	for(unsigned int x = 0 ; x < _n ; x++)
+		bits::set(_unplaced.data(), x);
+
+	unsigned int cost = 0;
+	for(unsigned int i = 0 ; i < prefix_size ; i++){
+		_cur[i] = prefix[i];
+		bits::reset(_unplaced.data(), prefix[i]);
+		for(unsigned int j = i - i % _p ; j < i ; j++)
+			cost += bits::test(&_met[prefix[i] * _nw], prefix[j]);
+	}
+
+	dfs(prefix_size, cost);
+	SGP_DEBUG(logger, "Week repair: %lu nodes, cost %u (bound %u)",
+											_nodes, _best_cost, bound);
+	return _found;
+}
+
+/**-------------------------------**/
+bool sgp::WeekRepair::dfs(unsigned int slot, unsigned int cost)
+{
+	if(++_nodes > _node_limit)
+		return false;
+	if(slot == _n){
+		/* pruning guarantees COST < _best_cost */
+		_best = _cur;
+		_best_cost = cost;
+		_found = true;
+		return true;
+	}
+
+	bits::word *members = &_members[(slot / _p) * _nw];
+	if(slot % _p == 0){
+		/* a new group starts with the lowest unplaced player */
+		unsigned int x = 0;
+		while(_unplaced[x / bits::WORD_BITS] == 0)
+			x += bits::WORD_BITS;
+		x += __builtin_ctzll(_unplaced[x / bits::WORD_BITS]);
+
+		_cur[slot] = x;
+		bits::reset(_unplaced.data(), x);
+		bits::clear(members, _nw);
+		bits::set(members, x);
+		const bool res = dfs(slot + 1, cost);
+		bits::set(_unplaced.data(), x);
+		return res;
+	}
+
+	/* candidates above the previous member, cheapest first */
+	std::uint64_t *keys = &_keys[slot * _n];
+	unsigned int size = 0;
+	const unsigned int last = _cur[slot - 1];
+	for(unsigned int i = last / bits::WORD_BITS ; i < _nw ; i++){
+		bits::word rest = _unplaced[i];
+		if(i == last / bits::WORD_BITS)
+			rest &= ~bits::word(0) << (last % bits::WORD_BITS);
+		for( ; rest ; rest &= rest - 1){
+			const unsigned int y = 
+							i * bits::WORD_BITS + __builtin_ctzll(rest);
+			const unsigned int c =
+							bits::count_and(&_met[y * _nw], members, _nw);
+			if(cost + c < _best_cost){
+				keys[size++] = 	(std::uint64_t(c) << 32) |
+								((_rng->next() >> 48) << 16) | y;
+			}
+		}
+	}
+	std::sort(keys, keys + size);
+
+	for(unsigned int i = 0 ; i < size ; i++){
+		const unsigned int c = keys[i] >> 32;
+		if(cost + c >= _best_cost)
+			break;
+		const unsigned int y = keys[i] & 0xffff;
+		_cur[slot] = y;
+		bits::reset(_unplaced.data(), y);
+		bits::set(members, y);
+		const bool res = dfs(slot + 1, cost + c);
+		bits::reset(members, y);
+		bits::set(_unplaced.data(), y);
+		if(!res)
+			return false;
+	}
+	return true;
+}
+
+
+/**================================**/
+/**=====  SGPLnsSolver  ===========**/
+/**================================**/
+template<class S>
+sgp::BasicSGPLnsSolver<S>::BasicSGPLnsSolver(	S& sgp,
+											unsigned int max_iterations,
+											unsigned int weeks,
+											unsigned long node_limit,
+											unsigned int steps,
+											unsigned int tabu_min,
+											unsigned int tabu_max)
+	: 	sgp(sgp),
+		tlist(sgp, tabu_min, tabu_max),
+		repair(sgp.g(), sgp.p()),
+		order(sgp.w()),
+		pinned(sgp.g() * sgp.p()),
+		runtime_(0),
+		wall_time_(0),
+		time_limit(0),
+		iterations_(0),
+		max_iterations(max_iterations),
+		weeks(std::min(weeks, sgp.w())),
+		node_limit(node_limit),
+		steps(steps),
+		cancel(nullptr)
+{}
+
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPLnsSolver<S>::destroy_repair()
+{
+	Random &rng = sgp.rng();
+	unsigned int w = 0;
+	for(unsigned int i = 0 ; i < sgp.w() ; i++){
+		if(sgp.frozen_groups(i) < sgp.g())
+			order[w++] = i;
+	}
+	if(w == 0)
+		return;
+
+	/* the worst week first (random ties), then random ones */
+	unsigned int worst = 0, worst_cost = 0, ties = 0;
+	for(unsigned int i = 0 ; i < w ; i++){
+		const unsigned int c = sgp.week_conflicts(order[i]);
+		if(c > worst_cost || ties == 0){
+			worst = i;
+			worst_cost = c;
+			ties = 1;
+		}else if(c == worst_cost && rng(++ties) == 0){
+			worst = i;
+		}
+	}
+	std::swap(order[0], order[worst]);
+	const unsigned int k = std::min(weeks, w);
+	for(unsigned int i = 1 ; i < k ; i++)
+		std::swap(order[i], order[i + rng(w - i)]);
+
+	for(unsigned int i = 0 ; i < k ; i++){
+		const unsigned int cost = sgp.week_conflicts(order[i]);
+		const unsigned int fixed = sgp.frozen_prefix(order[i], pinned.data());
+		sgp.met_outside_week(order[i], met);
+		if(repair.search(	met, cost + 1, node_limit, rng, 
+							pinned.data(), fixed))
+			sgp.set_week(order[i], repair.week().data());
+	}
+}
+
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPLnsSolver<S>::run(void)
+{
+	std::clock_t start = std::clock(); /* START TIME */
+	deadline.start(time_limit);
+	stats_.clear();
+	sgp.set_stats(&stats_);
+	tlist.clearAll();
+	sgp.init_solution();
+	stats_.restart_seconds = deadline.elapsed();
+	stats_.milestone(0, sgp.get_eval(), stats_.restart_seconds);
+
+	SGPSnapshot best;
+	sgp.save(best);
+	unsigned int it = 0;
+	for( ; it < max_iterations && best.eval != 0 ; it++){
+		if(cancel != nullptr && cancel->load(std::memory_order_relaxed)){
+			SGP_INFO(logger, "Cancelled after %u iterations", it);
+			break;
+		}
+		if(deadline.expired()){
+			SGP_INFO(logger, "Time limit reached after %u iterations", it);
+			stats_.timed_out = true;
+			break;
+		}
+
+		destroy_repair();
+		if(sgp.get_eval() < best.eval){
+			sgp.save(best);
+			stats_.milestone(it + 1, best.eval, deadline.elapsed());
+			SGP_INFO(logger, "New best sgp (%d) found by repair in "
+								"iteration %u", best.eval, it);
+		}
+
+		for(unsigned int s = 0 ; 
+				s < steps && best.eval != 0 && !deadline.expired() ; s++){
+			sgp.local_search(tlist, best.eval);
+			tlist.incr_iteration();
+			if(sgp.get_eval() < best.eval){
+				sgp.save(best);
+				stats_.milestone(it + 1, best.eval, deadline.elapsed());
+				SGP_INFO(logger, "New best sgp (%d) found in iteration %u",
+															best.eval, it);
+			}
+		}
+	}
+
+	this->runtime_ = 	(std::clock() - start ) /
+						static_cast<double>(CLOCKS_PER_SEC);
+	this->iterations_ = it;
+	stats_.iterations = it;
+	this->wall_time_ = deadline.elapsed();
+	stats_.search_seconds = wall_time_ - stats_.restart_seconds;
+	sgp.set_stats(nullptr);
+	sgp.restore(best);
+}
+
+/**-------------------------------**/
+template<class S>
+double sgp::BasicSGPLnsSolver<S>::runtime(){ return runtime_; }
+/**-------------------------------**/
+template<class S>
+double sgp::BasicSGPLnsSolver<S>::wall_time(){ return wall_time_; }
+/**-------------------------------**/
+template<class S>
+unsigned int sgp::BasicSGPLnsSolver<S>::iterations(){ return iterations_; }
+/**-------------------------------**/
+template<class S>
+unsigned int sgp::BasicSGPLnsSolver<S>::restarts(){ return 0; }
+/**-------------------------------**/
+template<class S>
+const sgp::SearchStats& sgp::BasicSGPLnsSolver<S>::stats() const
+{
+	return stats_;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPLnsSolver<S>::seed(std::uint64_t seed)
+{
+	sgp.seed(Random::derive(seed, 0));
+	tlist.seed(Random::derive(seed, 1));
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPLnsSolver<S>::set_cancel(const std::atomic<bool>* flag)
+{
+	cancel = flag;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPLnsSolver<S>::set_time_limit(double seconds)
+{
+	time_limit = seconds;
+}
+
+/**-------------------------------**/
+#define SGP_INSTANTIATE(G, P, W) 										\
+	template class sgp::BasicSGPLnsSolver<sgp::FixedSGP<G, P, W>>;
+
+template class sgp::BasicSGPLnsSolver<sgp::SGP>;
+SGP_FIXED_INSTANCES(SGP_INSTANTIATE)
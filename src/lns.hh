@@ -0,0 +1,135 @@
+#ifndef _LNS_HH
+#define _LNS_HH
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "bits.hh"
+#include "random.hh"
+#include "sgp.hh"
+#include "tabu.hh"
+#include "stats.hh"
+#include "deadline.hh"
+
+namespace sgp{
+
+/**
+ * Bounded exact search for the best partition of one week, given who
+ * has met whom in the other weeks (BasicSGP::met_outside_week).
+ * The cost of a partition is the number of its in-group pairs that
+ * have met before, which is the week's share of the eval.
+ * Groups are filled one after another, each starting with the lowest
+ * unplaced player and taking members in increasing order, so every
+ * partition is visited at most once; candidates are tried cheapest
+ * first with random ties, and branches that cannot beat the best
+ * partition found so far are cut.
+ */
+class WeekRepair{
+
+  public:
+	WeekRepair(unsigned int g, unsigned int p);
+
+	/**
+	 * Searches for a partition of cost below BOUND, visiting at most
+	 * NODE_LIMIT nodes. Returns true if one was found; the best one is
+	 * then available from week() and cost().
+	 * The first PREFIX_SIZE slots (whole groups) are taken from PREFIX
+	 * as they are, see BasicSGP::frozen_prefix.
+	 */
+	bool search(const std::vector<bits::word>& met, unsigned int bound,
+				unsigned long node_limit, Random& rng,
+				const int* prefix = nullptr, unsigned int prefix_size = 0);
+
+	/* N players, P per group, groups in order */
+	const std::vector<int>& week() const {	return _best;	}
+	unsigned int cost() const {	return _best_cost;	}
+	/* nodes visited by the last search */
+	unsigned long nodes() const {	return _nodes;	}
+
+  private:
+	unsigned int _g;
+	unsigned int _p;
+	unsigned int _n;
+	unsigned int _nw;
+	const bits::word* _met;
+	Random* _rng;
+	unsigned long _node_limit;
+	unsigned long _nodes;
+	unsigned int _best_cost;
+	bool _found;
+	std::vector<int> _cur;
+	std::vector<int> _best;
+	std::vector<bits::word> _unplaced;
+	/* members of the group being filled */
+	std::vector<bits::word> _members;
+	/* candidate keys, N per depth */
+	std::vector<std::uint64_t> _keys;
+
+	/* Returns false once the node limit is reached */
+	bool dfs(unsigned int slot, unsigned int cost);
+};
+
+/**
+ * Large neighbourhood search: every iteration destroys the week with
+ * the most conflicts and WEEKS - 1 more random weeks, rebuilds each of
+ * them with WeekRepair (never accepting a worse week, so equal-cost
+ * rebuilds let the search drift across plateaus) and then runs STEPS
+ * moves of local_search. The best solution is kept.
+ * Groups pinned by symmetry breaking are kept by the repair; fully
+ * pinned weeks are never destroyed.
+ * iterations() counts destroy and repair rounds.
+ */
+template<class S>
+class BasicSGPLnsSolver : public SGPSolver
+{
+	private:
+		S& sgp;
+		SGPFlatTabuList tlist;
+		WeekRepair repair;
+		std::vector<bits::word> met;	/* scratch rows of the repair */
+		std::vector<unsigned int> order;	/* scratch week order */
+		std::vector<int> pinned;	/* scratch frozen_prefix of a week */
+		double runtime_;
+		double wall_time_;
+		double time_limit;
+		Deadline deadline;
+		unsigned int iterations_;
+		SearchStats stats_;
+		unsigned int max_iterations;
+		unsigned int weeks;
+		unsigned long node_limit;
+		unsigned int steps;
+		const std::atomic<bool>* cancel;
+
+		/* Destroys and repairs the weeks of one iteration */
+		void destroy_repair();
+
+	public:
+		BasicSGPLnsSolver(	S& sgp, unsigned int max_iterations,
+							unsigned int weeks, unsigned long node_limit,
+							unsigned int steps,
+							unsigned int tabu_min, unsigned int tabu_max);
+		void run(void);
+		double runtime();
+		double wall_time();
+		unsigned int iterations();
+		/* Always 0: the search never starts over */
+		unsigned int restarts();
+		/**
+		 * Counters of the last run(); moves are those of local_search, 
+		 * the repairs are not counted.
+		 */
+		const SearchStats& stats() const;
+		/* Seeds the instance and the tabu list with derived streams */
+		void seed(std::uint64_t seed);
+		/* see BasicSGPTabuSolver::set_cancel */
+		void set_cancel(const std::atomic<bool>* flag);
+		/* see BasicSGPTabuSolver::set_time_limit */
+		void set_time_limit(double seconds);
+};
+
+typedef BasicSGPLnsSolver<SGP> SGPLnsSolver;
+
+} // NAMESPACE_SGP
+
+#endif //_LNS_HH
@@ -0,0 +1,74 @@
+#ifndef _LOG_HH
+#define _LOG_HH
+
+#include "log4cpp/Category.hh"
+
+/**
+ * Logging macros for the solver code.
+ * Statements below the compile-time level SGP_LOG_LEVEL expand to 
+ * nothing, arguments included. The levels follow the -l option of the
+ * command line: 1 DEBUG, 2 INFO, 3 WARN, 4 ERROR.
+ * SGP_TRACE stays compiled in but costs a single flag test unless 
+ * tracing was switched on with sgp::log::set_trace().
+ */
+#define SGP_LOG_DEBUG	1
+#define SGP_LOG_INFO	2
+#define SGP_LOG_WARN	3
+#define SGP_LOG_ERROR	4
+
+#ifndef SGP_LOG_LEVEL
+#define SGP_LOG_LEVEL SGP_LOG_INFO
+#endif
+
+#define SGP_LOG_AT(CAT, PRIORITY, ...)									\
+	do{																	\
+		log4cpp::Category& sgp_log_cat_ = (CAT);						\
+		if(sgp_log_cat_.isPriorityEnabled(log4cpp::Priority::PRIORITY))	\
+			sgp_log_cat_.log(log4cpp::Priority::PRIORITY, __VA_ARGS__);	\
+	}while(0)
+
+#define SGP_LOG_NOTHING() do{}while(0)
+
+#if SGP_LOG_LEVEL <= SGP_LOG_DEBUG
+#define SGP_DEBUG(CAT, ...)	SGP_LOG_AT(CAT, DEBUG, __VA_ARGS__)
+#else
+#define SGP_DEBUG(CAT, ...)	SGP_LOG_NOTHING()
+#endif
+
+#if SGP_LOG_LEVEL <= SGP_LOG_INFO
+#define SGP_INFO(CAT, ...)	SGP_LOG_AT(CAT, INFO, __VA_ARGS__)
+#else
+#define SGP_INFO(CAT, ...)	SGP_LOG_NOTHING()
+#endif
+
+#if SGP_LOG_LEVEL <= SGP_LOG_WARN
+#define SGP_WARN(CAT, ...)	SGP_LOG_AT(CAT, WARN, __VA_ARGS__)
+#else
+#define SGP_WARN(CAT, ...)	SGP_LOG_NOTHING()
+#endif
+
+#define SGP_ERROR(CAT, ...)	SGP_LOG_AT(CAT, ERROR, __VA_ARGS__)
+
+/* Written at NOTICE priority so that it shows at the default -l 2 */
+#define SGP_TRACE(CAT, ...)												\
+	do{																	\
+		if(sgp::log::trace_enabled)										\
+			(CAT).notice(__VA_ARGS__);									\
+	}while(0)
+
+namespace sgp{
+
+namespace log{
+
+extern bool trace_enabled;
+
+inline void set_trace(bool on) {	trace_enabled = on;	}
+
+/* true if SGP_DEBUG statements were compiled in */
+inline bool debug_compiled() {	return SGP_LOG_LEVEL <= SGP_LOG_DEBUG;	}
+
+} // NAMESPACE_LOG
+
+} // NAMESPACE_SGP
+
+#endif //_LOG_HH
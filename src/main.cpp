@@ -3,14 +3,155 @@
 #include "log4cpp/Layout.hh"
 #include "log4cpp/BasicLayout.hh"
 #include "log4cpp/Priority.hh"
-#include "log4cpp/Ostreamappender.hh"
+#include "log4cpp/OstreamAppender.hh"
 #include "log4cpp/FileAppender.hh"
 #include <boost/program_options.hpp>
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <exception>
 #include "sgp.hh"
 #include "tabu.hh"
+#include "kernel.hh"
+#include "engine.hh"
+#include "elite.hh"
+#include "batch.hh"
 
 namespace po = boost::program_options;
 
+namespace {
+
+enum class ALGORITHM {
+	TABU,
+	GRASP,
+	LNS
+};
+
+/* Named options of the command line, validated by parse_choices */
+struct Choices{
+	ALGORITHM algorithm;
+	sgp::TABU_LIST tabu_list;
+	sgp::INIT_ALG init_alg;
+	sgp::SYMMETRY symmetry;
+	bool dynamic;
+};
+
+/**-------------------------------**/
+/* Fills CHOICES from VM; reports an unknown name and returns false */
+bool parse_choices(const po::variables_map& vm, Choices& choices)
+{
+	const std::string &list_name = vm["tabu-list"].as<std::string>();
+	if(list_name == "dotu"){
+		choices.tabu_list = sgp::TABU_LIST::DOTU;
+	}else if(list_name == "flat"){
+		choices.tabu_list = sgp::TABU_LIST::FLAT;
+	}else{
+		std::cerr << "Unknown tabu list: " << list_name << std::endl;
+		return false;
+	}
+	const std::string &init_name = vm["init"].as<std::string>();
+	if(init_name == "random"){
+		choices.init_alg = sgp::INIT_ALG::RANDOM;
+	}else if(init_name == "greedy"){
+		choices.init_alg = sgp::INIT_ALG::GREEDY;
+	}else{
+		std::cerr << "Unknown initialization: " << init_name << std::endl;
+		return false;
+	}
+	const std::string &symmetry_name = vm["symmetry"].as<std::string>();
+	if(symmetry_name == "none"){
+		choices.symmetry = sgp::SYMMETRY::NONE;
+	}else if(symmetry_name == "week"){
+		choices.symmetry = sgp::SYMMETRY::FIRST_WEEK;
+	}else if(symmetry_name == "group"){
+		choices.symmetry = sgp::SYMMETRY::FIRST_WEEK_AND_GROUP;
+	}else{
+		std::cerr << "Unknown symmetry breaking: " << symmetry_name 
+					<< std::endl;
+		return false;
+	}
+	const std::string &engine = vm["engine"].as<std::string>();
+	if(engine != "auto" && engine != "dynamic"){
+		std::cerr << "Unknown engine: " << engine << std::endl;
+		return false;
+	}
+	choices.dynamic = engine == "dynamic";
+	return true;
+}
+
+/**-------------------------------**/
+/**
+ * Builds the solver chosen on the command line for <G, P, W>; 
+ * THREADS > 1 races that many of them. Throws std::invalid_argument 
+ * for a symmetry breaking the instance does not allow.
+ */
+std::unique_ptr<sgp::SGPInstanceSolver> 
+make_solver(const po::variables_map& vm, const Choices& choices,
+			unsigned int g, unsigned int p, unsigned int w, 
+			unsigned int threads)
+{
+	const unsigned int tabu_min = vm["min-tabu"].as<unsigned int>();
+	const unsigned int tabu_max = vm["max-tabu"].as<unsigned int>();
+	std::unique_ptr<sgp::SGPInstanceSolver> solver;
+	switch(choices.algorithm){
+		case ALGORITHM::GRASP:
+			if(threads > 1){
+				solver = sgp::make_parallel_grasp_solver(threads, g, p, w,
+									vm["grasp-iterations"].as<unsigned int>(),
+									vm["grasp-steps"].as<unsigned int>(),
+									vm["rcl"].as<unsigned int>(),
+									tabu_min, tabu_max, choices.dynamic);
+			}else{
+				solver = sgp::make_grasp_solver(g, p, w,
+									vm["grasp-iterations"].as<unsigned int>(),
+									vm["grasp-steps"].as<unsigned int>(),
+									vm["rcl"].as<unsigned int>(),
+									tabu_min, tabu_max, choices.dynamic);
+			}
+			break;
+		case ALGORITHM::LNS:
+			if(threads > 1){
+				solver = sgp::make_parallel_lns_solver(threads, g, p, w,
+									vm["lns-iterations"].as<unsigned int>(),
+									vm["lns-weeks"].as<unsigned int>(),
+									vm["lns-nodes"].as<unsigned long>(),
+									vm["lns-steps"].as<unsigned int>(),
+									tabu_min, tabu_max, choices.dynamic);
+			}else{
+				solver = sgp::make_lns_solver(g, p, w,
+									vm["lns-iterations"].as<unsigned int>(),
+									vm["lns-weeks"].as<unsigned int>(),
+									vm["lns-nodes"].as<unsigned long>(),
+									vm["lns-steps"].as<unsigned int>(),
+									tabu_min, tabu_max, choices.dynamic);
+			}
+			solver->set_init_alg(choices.init_alg);
+			break;
+		case ALGORITHM::TABU:
+			if(threads > 1){
+				solver = sgp::make_parallel_tabu_solver(threads, 
+									choices.tabu_list, g, p, w,
+									vm["max-tries"].as<unsigned int>(),
+									vm["max-stable-tries"].as<unsigned int>(),
+									tabu_min, tabu_max, choices.dynamic);
+			}else{
+				solver = sgp::make_tabu_solver(choices.tabu_list, g, p, w,
+									vm["max-tries"].as<unsigned int>(),
+									vm["max-stable-tries"].as<unsigned int>(),
+									tabu_min, tabu_max, choices.dynamic);
+			}
+			solver->set_init_alg(choices.init_alg);
+			break;
+	}
+	solver->set_symmetry(choices.symmetry);
+	solver->set_time_limit(vm["time-limit"].as<double>());
+	return solver;
+}
+
+} // NAMESPACE
+
 int main(int argc , char **argv){
 	
 	log4cpp::Appender* console_appender=
@@ -45,7 +186,71 @@ int main(int argc , char **argv){
 		 				"Maximum tabu iteration for elements")
 		("logger,l", 	po::value<unsigned int>()->default_value(2), 
 		 				"Log level")
+		("trace",		"Log every move of the local search")
+		("threads,t",	po::value<unsigned int>()->default_value(1), 
+		 				"Independent tabu searches run in parallel; "
+						"the first to solve the instance stops the others")
+		("scan-threads",	po::value<unsigned int>()->default_value(1), 
+		 				"Threads sharing the move scan of a single search "
+						"(large instances)")
+		("elite",		po::value<unsigned int>()->default_value(0), 
+		 				"Size of the elite pool shared by the searches; "
+						"0 restarts every search from a random solution")
+		("perturb",		po::value<unsigned int>(), 
+		 				"Random swaps applied to an elite solution "
+						"before restarting from it (default: #weeks)")
 		("tabu",		"Try tabu search")
+		("batch",		po::value<std::string>(), 
+		 				"Solve every instance of FILE (lines \"G P W [SEED] "
+						"[TIME_LIMIT]\") with the chosen algorithm, "
+						"--threads at a time, one result line each")
+		("grasp",		"Try GRASP instead of tabu search")
+		("lns",			"Try large neighbourhood search instead of tabu search")
+		("lns-iterations",	po::value<unsigned int>()->default_value(1000), 
+		 				"LNS destroy and repair rounds")
+		("lns-weeks",	po::value<unsigned int>()->default_value(2), 
+		 				"Weeks rebuilt by every LNS round")
+		("lns-nodes",	po::value<unsigned long>()->default_value(20000), 
+		 				"Search nodes allowed to rebuild one week")
+		("lns-steps",	po::value<unsigned int>()->default_value(100), 
+		 				"Local search moves after every LNS round")
+		("grasp-iterations",	po::value<unsigned int>()->default_value(1000), 
+		 				"GRASP constructions")
+		("grasp-steps",	po::value<unsigned int>()->default_value(500), 
+		 				"Local search moves after every GRASP construction")
+		("rcl",			po::value<unsigned int>()->default_value(3), 
+		 				"Restricted candidate list length of the GRASP "
+						"construction")
+		("tabu-list",	po::value<std::string>()->default_value("dotu"), 
+		 				"Tabu list implementation: dotu | flat")
+		("init",		po::value<std::string>()->default_value("random"), 
+		 				"Construction of the initial and restart solutions: "
+						"random | greedy (Triska & Musliu)")
+		("time-limit",	po::value<double>()->default_value(0), 
+		 				"Wall-clock seconds a search may take; it then "
+						"returns the best schedule found so far "
+						"(0: no limit; in batch mode a job's own limit "
+						"comes first)")
+		("seed",		po::value<unsigned long long>(), 
+		 				"Random seed (default: drawn from std::random_device)")
+		("symmetry",	po::value<std::string>()->default_value("none"), 
+		 				"Symmetry breaking: none | week (pin week 1 to "
+						"the canonical partition) | group (also pin the "
+						"first group of week 2)")
+		("stats",		po::value<std::string>(), 
+		 				"Write the counters of the run as JSON to FILE "
+						"(- for standard output)")
+		("checkpoint",	po::value<std::string>(), 
+		 				"Save the tabu search to FILE every --checkpoint-every "
+						"iterations and when it stops")
+		("checkpoint-every",	po::value<unsigned int>()->default_value(100000), 
+		 				"Iterations between two checkpoints")
+		("resume",		po::value<std::string>(), 
+		 				"Continue the tabu search saved in FILE (same "
+						"instance, tabu list and engine)")
+		("engine",		po::value<std::string>()->default_value("auto"), 
+		 				"auto: compile-time sized engine for registered "
+						"instances | dynamic: always the run-time sized one")
         ;
    
 	pos.add("group", 1);
@@ -71,6 +276,10 @@ int main(int argc , char **argv){
         return EXIT_FAILURE;
     }
 
+	const std::uint64_t seed = vm.count("seed") ? 
+							vm["seed"].as<unsigned long long>() : 
+							sgp::Random::entropy();
+
 	//Print info!
 	std::cout << "Solving SGP( :\t" << vm["group"].as<unsigned int>() << " , "
 									<< vm["player"].as<unsigned int>() << " , "
@@ -84,6 +293,9 @@ int main(int argc , char **argv){
 				<< vm["max-tries"].as<unsigned int>() << std::endl
 				<< ", Maximum Stable Tries:\t"
 				<< vm["max-stable-tries"].as<unsigned int>() << std::endl
+				<< ", Scoring kernel:\t"
+				<< sgp::kernel::name(sgp::kernel::active()) << std::endl
+				<< ", Seed:\t" << seed << std::endl
 				<< std::endl;
 				
 
@@ -92,6 +304,9 @@ int main(int argc , char **argv){
 	
 		case 1:
 			root.setPriority(log4cpp::Priority::DEBUG);
+			if(!sgp::log::debug_compiled())
+				std::cerr 	<< "Debug logging is compiled out, "
+							<< "rebuild with LOG_LEVEL=1" << std::endl;
 			break;
 		case 2:
 			root.setPriority(log4cpp::Priority::INFO);
@@ -114,29 +329,181 @@ int main(int argc , char **argv){
 
 	}
 	
-	/* Initializing the problem */
-	sgp::SGP sgp1( 	vm["group"].as<unsigned int>(),
-					vm["player"].as<unsigned int>(),
-					vm["week"].as<unsigned int>());
+	sgp::log::set_trace(vm.count("trace") > 0);
 
 	double total = 0;
 	
+	const bool grasp = vm.count("grasp") > 0;
+	const bool lns = !grasp && vm.count("lns") > 0;
+	const bool batch = vm.count("batch") > 0;
 	
-	if(vm.count("tabu")){
-		sgp::SGPDotuTabuSolver tabuSolver(	sgp1, 
-										 vm["max-tries"].as<unsigned int>(),
-									vm["max-stable-tries"].as<unsigned int>(),
-										 vm["min-tabu"].as<unsigned int>(),
-										 vm["max-tabu"].as<unsigned int>());
-		tabuSolver.run();
-		std::cout << sgp1 << std::endl;
-		std::cout 	<< "Tabu search finished\nRUNTIME  = " 
-					<< tabuSolver.runtime() << " sec." 
+	if(vm.count("tabu") || grasp || lns || batch){
+		Choices choices;
+		choices.algorithm = grasp ? 	ALGORITHM::GRASP : 
+							lns ? 	ALGORITHM::LNS : ALGORITHM::TABU;
+		if(!parse_choices(vm, choices))
+			return EXIT_FAILURE;
+
+		const unsigned int threads = vm["threads"].as<unsigned int>();
+		const unsigned int scan_threads = 
+								vm["scan-threads"].as<unsigned int>();
+		if(vm["time-limit"].as<double>() < 0){
+			std::cerr << "The time limit cannot be negative" << std::endl;
+			return EXIT_FAILURE;
+		}
+		if(threads == 0 || scan_threads == 0){
+			std::cerr << "At least one thread is needed" << std::endl;
+			return EXIT_FAILURE;
+		}
+		if(threads > 1 && scan_threads > 1){
+			std::cerr 	<< "--threads and --scan-threads cannot be combined" 
+						<< std::endl;
+			return EXIT_FAILURE;
+		}
+		if((grasp || lns || batch) && vm["elite"].as<unsigned int>() > 0){
+			std::cerr 	<< (grasp ? "GRASP" : lns ? "LNS" : "Batch mode") 
+						<< " does not use an elite pool" << std::endl;
+			return EXIT_FAILURE;
+		}
+		const bool checkpoints = vm.count("checkpoint") || vm.count("resume");
+		if(checkpoints && (batch || vm["elite"].as<unsigned int>() > 0)){
+			std::cerr 	<< "Checkpoints cannot be combined with "
+						<< (batch ? "batch mode" : "an elite pool") << std::endl;
+			return EXIT_FAILURE;
+		}
+		if(	vm.count("checkpoint") && 
+			vm["checkpoint-every"].as<unsigned int>() == 0){
+			std::cerr << "--checkpoint-every must be positive" << std::endl;
+			return EXIT_FAILURE;
+		}
+		/* opened before the run, which a bad path would otherwise waste */
+		std::ofstream stats_file;
+		if(vm.count("stats")){
+			const std::string &name = vm["stats"].as<std::string>();
+			if(batch){
+				std::cerr 	<< "--stats cannot be combined with batch mode" 
+							<< std::endl;
+				return EXIT_FAILURE;
+			}
+			if(name != "-"){
+				stats_file.open(name);
+				if(!stats_file){
+					std::cerr << "Cannot open " << name << std::endl;
+					return EXIT_FAILURE;
+				}
+			}
+		}
+
+		if(batch){
+			if(scan_threads > 1){
+				std::cerr 	<< "Batch mode runs one search per thread, "
+							<< "use --threads" << std::endl;
+				return EXIT_FAILURE;
+			}
+			std::ifstream file(vm["batch"].as<std::string>());
+			if(!file){
+				std::cerr 	<< "Cannot open " << vm["batch"].as<std::string>()
+							<< std::endl;
+				return EXIT_FAILURE;
+			}
+			std::vector<sgp::BatchJob> jobs;
+			try{
+				jobs = sgp::read_batch(file);
+			}catch(const std::invalid_argument &e){
+				std::cerr << e.what() << std::endl;
+				return EXIT_FAILURE;
+			}
+			sgp::run_batch(jobs, threads, seed, 
+					[&](const sgp::BatchJob& job){
+						return make_solver(vm, choices, 
+											job.g, job.p, job.w, 1);
+					}, std::cout);
+			return EXIT_SUCCESS;
+		}
+
+		const unsigned int g = vm["group"].as<unsigned int>();
+		const unsigned int p = vm["player"].as<unsigned int>();
+		const unsigned int w = vm["week"].as<unsigned int>();
+		std::unique_ptr<sgp::ElitePool> elite;
+		if(vm["elite"].as<unsigned int>() > 0){
+			/* 
+			 * one swap changes at most 4 * (P - 1) pairs: members that 
+			 * differ in fewer are considered the same 
+			 */
+			elite.reset(new sgp::ElitePool(	g, p, w, 
+											vm["elite"].as<unsigned int>(),
+											4 * (p - 1)));
+		}
+
+		/* Initializing the problem */
+		std::unique_ptr<sgp::SGPInstanceSolver> solver;
+		try{
+			solver = make_solver(vm, choices, g, p, w, threads);
+		}catch(const std::invalid_argument &e){
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		sgp::SGPParallelSolver *parallel = 
+					dynamic_cast<sgp::SGPParallelSolver*>(solver.get());
+		std::unique_ptr<sgp::WorkerPool> scan_pool;
+		if(scan_threads > 1){
+			scan_pool.reset(new sgp::WorkerPool(scan_threads));
+			solver->set_worker_pool(scan_pool.get());
+		}
+		if(elite){
+			solver->set_elite_pool(elite.get(), 
+							vm.count("perturb") ? 
+								vm["perturb"].as<unsigned int>() : w);
+		}
+		std::cout 	<< "Engine:\t" 
+					<< (solver->fixed() ? "fixed" : "dynamic") 
+					<< std::endl;
+		solver->seed(seed);
+		try{
+			if(vm.count("checkpoint")){
+				solver->set_checkpoint(vm["checkpoint"].as<std::string>(),
+								vm["checkpoint-every"].as<unsigned int>());
+			}
+			if(vm.count("resume"))
+				solver->resume(vm["resume"].as<std::string>());
+		}catch(const std::invalid_argument &e){
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		try{
+			solver->run();
+		}catch(const std::exception &e){
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		solver->print(std::cout);
+		std::cout << std::endl;
+		std::cout 	<< (grasp ? "GRASP" : lns ? "LNS" : "Tabu search") 
+					<< " finished\nRUNTIME  = " 
+					<< solver->runtime() << " sec. (CPU)" 
+					<< std::endl
+					<< "WALL TIME = " << solver->wall_time() << " sec."
+					<< (solver->stats().timed_out ? " (time limit reached)" : "")
 					<< std::endl
-					<< "ITERATIONS: " << tabuSolver.iterations()
+					<< "ITERATIONS: " << solver->iterations()
 					<<std::endl;
+		if(parallel != nullptr){
+			std::cout 	<< "WORKERS: " << parallel->workers() 
+						<< ", WINNER: " << parallel->winner()
+						<< (parallel->solved() ? " (solved)" : " (best eval)")
+						<< std::endl;
+		}
+		if(elite){
+			std::cout 	<< "ELITE POOL: " << elite->size() << " members, "
+						<< "best eval " << elite->best_eval() << std::endl;
+		}
+		if(vm.count("stats")){
+			std::ostream &os = stats_file.is_open() ? stats_file : std::cout;
+			solver->stats().print_json(os);
+			os << std::endl;
+		}
 
-		total += tabuSolver.runtime();
+		total += solver->runtime();
 	}
 	/*std::cout 	<< "---------FINAL BEST SOLUTION-----------" 
 				<< std::endl;
@@ -146,4 +513,3 @@ int main(int argc , char **argv){
 	*/
 	return 0;
 }
-
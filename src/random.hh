@@ -0,0 +1,110 @@
+#ifndef _RANDOM_HH
+#define _RANDOM_HH
+
+#include <cstdint>
+#include <random>
+
+namespace sgp{
+
+/**
+ * Small, fast pseudo random generator (xoshiro256**).
+ * The 256 bit state is expanded from a 64 bit seed with splitmix64, so
+ * equal seeds give equal streams on every platform.
+ * Each solver, instance and tabu list owns its own generator; a
+ * generator must not be shared between threads.
+ */
+class Random{
+
+  public:
+	typedef std::uint64_t result_type;
+
+	/* Seeded from std::random_device */
+	Random() { seed(entropy()); }
+
+	explicit Random(std::uint64_t s) { seed(s); }
+
+	inline void seed(std::uint64_t s){
+		for(int i = 0 ; i < 4 ; ++i)
+			_s[i] = splitmix64(s);
+	}
+
+	/* 64 uniformly distributed bits */
+	inline std::uint64_t next(){
+		const std::uint64_t res = rotl(_s[1] * 5, 7) * 9;
+		const std::uint64_t t = _s[1] << 17;
+		_s[2] ^= _s[0];
+		_s[3] ^= _s[1];
+		_s[1] ^= _s[2];
+		_s[0] ^= _s[3];
+		_s[2] ^= t;
+		_s[3] = rotl(_s[3], 45);
+		return res;
+	}
+
+	/**
+	 * Unbiased integer in [0, N) (Lemire's multiply-and-reject).
+	 * Returns 0 for N = 0.
+	 */
+	inline unsigned int operator()(unsigned int n){
+		std::uint64_t m = (next() >> 32) * n;
+		std::uint32_t low = static_cast<std::uint32_t>(m);
+		if(low < n){
+			const std::uint32_t threshold = -n % n;
+			while(low < threshold){
+				m = (next() >> 32) * n;
+				low = static_cast<std::uint32_t>(m);
+			}
+		}
+		return static_cast<unsigned int>(m >> 32);
+	}
+
+	/* Copies the 256 bit state to STATE */
+	inline void save(std::uint64_t state[4]) const{
+		for(int i = 0 ; i < 4 ; ++i)
+			state[i] = _s[i];
+	}
+
+	/* Continues the stream recorded by save() */
+	inline void restore(const std::uint64_t state[4]){
+		for(int i = 0 ; i < 4 ; ++i)
+			_s[i] = state[i];
+	}
+
+	/* Uniform double in [0, 1) */
+	inline double uniform(){
+		return (next() >> 11) * (1.0 / (std::uint64_t(1) << 53));
+	}
+
+	/* A nondeterministic seed */
+	static std::uint64_t entropy(){
+		std::random_device rdev;
+		return (std::uint64_t(rdev()) << 32) ^ rdev();
+	}
+
+	/**
+	 * Seed of the K-th independent stream derived from SEED;
+	 * used to give every component of a solver its own generator.
+	 */
+	static std::uint64_t derive(std::uint64_t seed, std::uint64_t k){
+		std::uint64_t s = seed + k * 0x9e3779b97f4a7c15ULL;
+		return splitmix64(s);
+	}
+
+  private:
+	std::uint64_t _s[4];
+
+	static inline std::uint64_t rotl(std::uint64_t x, int k){
+		return (x << k) | (x >> (64 - k));
+	}
+
+	static inline std::uint64_t splitmix64(std::uint64_t& x){
+		std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+};
+
+} // NAMESPACE_SGP
+
+#endif //_RANDOM_HH
@@ -1,18 +1,23 @@
 #include <sstream>
 #include <iomanip>
-#include <random>
 #include <cassert>
 #include <algorithm>
 #include <utility>
 #include <ctime>
+#include <numeric>
+#include <iostream>
 
 #include "sgp.hh"
 #include "tabu.hh"
+#include "engine.hh"
+#include "stats.hh"
+
+bool sgp::log::trace_enabled = false;
 
 /**-----------------------------------------------------------------------**/
 sgp::decision::decision(unsigned int w, unsigned int g, 
 										unsigned int val)
-	: w(w), g(g), val(val), erased(false) 
+	: w(w), g(g), val(val)
 {}
 /**-----------------------------------------------------------------------**/
 namespace sgp{
@@ -43,60 +48,138 @@ std::size_t sgp::decisionHash::operator() (const sgp::decision& d) const{
 
 
 /**-----------------------------------------------------------------------**/
-sgp::SGP::SGP(unsigned int g, unsigned int p, unsigned int w) : 
-	_g(g) , _p(p), _w(w),
-	_tables(_w , 
-			std::vector<std::set<int>>(_g , std::set<int>())
-			),
+template<class Dims>
+sgp::BasicSGP<Dims>::BasicSGP(unsigned int g, unsigned int p, unsigned int w) : 
+	Dims(g, p, w),
+	_tables(_w * _g * _p, UNSET),
+	_tables_size(_w * _g, 0),
 	_groups(_w , std::vector<int>(_g * _p, -1)),
-	_conflict_matrix( _g * _p , std::vector<int>(_g * _p , 0) ),
-	is_in_conflict_set(_g * _p, false)
-	/*conflict_set(w * g * p / 2, decisionHash(g,p,w))*/
+	_conflict_matrix( _g * _p ),
+	/* one count of padding for the gathers of kernel::score_swaps */
+	_met_in_group(_w * _g * _g * _p + 1, 0),
+	_twice_in_group(_w * _g * _g * _p + 1, 0),
+	_met_once(_g * _p * bits::words(_g * _p), 0),
+	_met_twice(_g * _p * bits::words(_g * _p), 0),
+	_group_mask(_w * _g * bits::words(_g * _p), 0),
+	_frozen(_w * bits::words(_g * _p), 0),
+	_first_group(_w, 0),
+	conflict_set(_w, _g * _p)
 {
+	if(_w > ConflictMatrix::MAX_COUNT)
+		throw std::domain_error("too many weeks for the conflict matrix");
 	best_eval = 0;
 	//init_solution();	
 }
 
 /**-----------------------------------------------------------------------**/
-sgp::SGP& sgp::SGP::operator=(sgp::SGP& other){
-	_g = other._g;
-	_p = other._p;
-	_w = other._w;
+template<class Dims>
+sgp::BasicSGP<Dims>& 
+sgp::BasicSGP<Dims>::operator=(const sgp::BasicSGP<Dims>& other){
+	Dims::operator=(other);
 	best_eval = other.best_eval;
 	_tables = other._tables;
+	_tables_size = other._tables_size;
 	_groups = other._groups;
 	_conflict_matrix = other._conflict_matrix;
+	_met_in_group = other._met_in_group;
+	_twice_in_group = other._twice_in_group;
+	_met_once = other._met_once;
+	_met_twice = other._met_twice;
+	_group_mask = other._group_mask;
 	_init_alg = other._init_alg;
-	is_in_conflict_set= other.is_in_conflict_set;
+	_symmetry = other._symmetry;
+	_frozen = other._frozen;
+	_first_group = other._first_group;
+	conflict_set = other.conflict_set;
 
 	return *this;
 }
 
 /**-----------------------------------------------------------------------**/
-sgp::SGP::SGP(const SGP& sgp)
-	: 	_g(sgp._g), _p(sgp._p), _w(sgp._w),
+template<class Dims>
+sgp::BasicSGP<Dims>::BasicSGP(const BasicSGP& sgp)
+	: 	Dims(sgp),
 		best_eval(sgp.best_eval),
 		_tables(sgp._tables),
+		_tables_size(sgp._tables_size),
 		_groups(sgp._groups),
 		_conflict_matrix(sgp._conflict_matrix),
-		is_in_conflict_set(sgp.is_in_conflict_set),
+		_met_in_group(sgp._met_in_group),
+		_twice_in_group(sgp._twice_in_group),
+		_met_once(sgp._met_once),
+		_met_twice(sgp._met_twice),
+		_group_mask(sgp._group_mask),
 		_init_alg(sgp._init_alg),
-		conflict_set(sgp.conflict_set)
+		_symmetry(sgp._symmetry),
+		_frozen(sgp._frozen),
+		_first_group(sgp._first_group),
+		conflict_set(sgp.conflict_set),
+		_rng(sgp._rng)
 {}
 
 /**-----------------------------------------------------------------------**/
-unsigned int sgp::SGP::p() const {	return _p;	}
+template<class Dims>
+sgp::BasicSGP<Dims>::BasicSGP(BasicSGP&& sgp) noexcept
+	: 	Dims(sgp),
+		best_eval(sgp.best_eval),
+		_tables(std::move(sgp._tables)),
+		_tables_size(std::move(sgp._tables_size)),
+		_groups(std::move(sgp._groups)),
+		_conflict_matrix(std::move(sgp._conflict_matrix)),
+		_met_in_group(std::move(sgp._met_in_group)),
+		_twice_in_group(std::move(sgp._twice_in_group)),
+		_met_once(std::move(sgp._met_once)),
+		_met_twice(std::move(sgp._met_twice)),
+		_group_mask(std::move(sgp._group_mask)),
+		_init_alg(sgp._init_alg),
+		_symmetry(sgp._symmetry),
+		_frozen(std::move(sgp._frozen)),
+		_first_group(std::move(sgp._first_group)),
+		conflict_set(std::move(sgp.conflict_set)),
+		_rng(sgp._rng)
+{}
+
+/**-----------------------------------------------------------------------**/
+template<class Dims>
+sgp::BasicSGP<Dims>& 
+sgp::BasicSGP<Dims>::operator=(sgp::BasicSGP<Dims>&& other) noexcept{
+	Dims::operator=(other);
+	best_eval = other.best_eval;
+	_tables = std::move(other._tables);
+	_tables_size = std::move(other._tables_size);
+	_groups = std::move(other._groups);
+	_conflict_matrix = std::move(other._conflict_matrix);
+	_met_in_group = std::move(other._met_in_group);
+	_twice_in_group = std::move(other._twice_in_group);
+	_met_once = std::move(other._met_once);
+	_met_twice = std::move(other._met_twice);
+	_group_mask = std::move(other._group_mask);
+	_init_alg = other._init_alg;
+	_symmetry = other._symmetry;
+	_frozen = std::move(other._frozen);
+	_first_group = std::move(other._first_group);
+	conflict_set = std::move(other.conflict_set);
+
+	return *this;
+}
+
+/**-----------------------------------------------------------------------**/
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::p() const {	return _p;	}
 
 /**-----------------------------------------------------------------------**/
- unsigned int sgp::SGP::g() const {	return _g;	}
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::g() const {	return _g;	}
 
 /**-----------------------------------------------------------------------**/
- unsigned int sgp::SGP::w() const {	return _w;	}
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::w() const {	return _w;	}
 
 /**-----------------------------------------------------------------------**/
 namespace sgp
 {
-std::ostream& operator<<(std::ostream& os , const sgp::SGP& sgp)
+template<class Dims>
+std::ostream& operator<<(std::ostream& os , const BasicSGP<Dims>& sgp)
 {
 
 	int week_in_row = 4;
@@ -123,9 +206,10 @@ std::ostream& operator<<(std::ostream& os , const sgp::SGP& sgp)
 
 		for(unsigned  int gr = 0 ; gr < sgp._g ; gr++){
 			for( int wir = 0 ; wir < week_in_row ; wir++ ){
-				for(const int &p : sgp._tables[week_table_cnt + wir][gr]){
+				for(const int *p = sgp.group_begin(week_table_cnt + wir, gr);
+						p != sgp.group_end(week_table_cnt + wir, gr); ++p){
 						os 	<< std::setw(3) 
-							<< p;
+							<< *p;
 				}
 				os << std::setw(8) << "";  // group seperator
 			}
@@ -147,7 +231,8 @@ std::ostream& operator<<(std::ostream& os , const sgp::SGP& sgp)
 }
 
 /**-----------------------------------------------------------------------**/
-std::string sgp::SGP::get_conflict_matrix_str() const
+template<class Dims>
+std::string sgp::BasicSGP<Dims>::get_conflict_matrix_str() const
 {
 	std::stringstream ss;
 
@@ -167,7 +252,7 @@ std::string sgp::SGP::get_conflict_matrix_str() const
 	for(unsigned int i = 0 ; i < _g*_p ; ++i){
 		ss << std::setw(2) << i << "|" ; 
 		for(unsigned  int j = 0; j < _g*_p; ++j){
-			int c = _conflict_matrix[i][j];
+			int c = _conflict_matrix(i, j);
 			ss << std::setw(3) << c ;
 		}
 		ss << std::endl;
@@ -177,73 +262,469 @@ std::string sgp::SGP::get_conflict_matrix_str() const
 }
 
 /**------------------------------------------------------------------------**/
-void sgp::SGP::set_init_alg(sgp::INIT_ALG alg){
+template<class Dims>
+void sgp::BasicSGP<Dims>::set_init_alg(sgp::INIT_ALG alg){
 	this->_init_alg = alg;
 }
 
 /**------------------------------------------------------------------------**/
-void sgp::SGP::init_solution()
-{
+template<class Dims>
+sgp::INIT_ALG sgp::BasicSGP<Dims>::init_alg() const{
+	return _init_alg;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+sgp::SYMMETRY sgp::BasicSGP<Dims>::symmetry() const{
+	return _symmetry;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::set_symmetry(sgp::SYMMETRY mode){
+	if(mode == SYMMETRY::FIRST_WEEK_AND_GROUP && _p > _g)
+		throw std::invalid_argument("cannot pin a group of week 1: P > G");
+
+	_symmetry = mode;
+	std::fill(_frozen.begin(), _frozen.end(), 0);
+	std::fill(_first_group.begin(), _first_group.end(), 0);
+	if(mode == SYMMETRY::NONE)
+		return;
+
+	_first_group[0] = _g;
+	if(mode == SYMMETRY::FIRST_WEEK_AND_GROUP && _w > 1)
+		_first_group[1] = 1;
 
+	/* week 0 is the identity, the first group of week 1 is 0, P, 2P.. */
+	for(unsigned int x = 0 ; x < _g * _p ; x++)
+		bits::set(&_frozen[0], x);
+	for(unsigned int i = 0 ; _w > 1 && i < _first_group[1] * _p ; i++)
+		bits::set(&_frozen[_mask_words], i * _p);
+}
 
+/**------------------------------------------------------------------------**/
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::frozen_groups(unsigned int w) const{
+	return _first_group[w];
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::frozen_prefix(unsigned int w, 
+												int* week) const{
+	const unsigned int n = _g * _p;
+	const unsigned int k = _first_group[w] * _p;
+	for(unsigned int i = 0 ; i < k ; i++)
+		week[i] = w == 0 ? i : i * _p;
+	unsigned int i = k;
+	for(unsigned int x = 0 ; x < n ; x++){
+		if(!frozen(w, x))
+			week[i++] = x;
+	}
+	return k;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::seed(std::uint64_t seed){
+	_rng.seed(seed);
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+sgp::Random& sgp::BasicSGP<Dims>::rng(){
+	return _rng;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::set_worker_pool(WorkerPool* pool){
+	_workers = pool;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::set_stats(SearchStats* stats){
+	_stats = stats;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::clear_solution()
+{
 	this->best_eval = 0;
 	conflict_set.clear();
-	is_in_conflict_set = std::vector<bool>(_g * _p, false);
-	_groups = std::vector<std::vector<int>>(_w , std::vector<int>(_g * _p, -1));
+	for(std::vector<int> &week : _groups)
+		std::fill(week.begin(), week.end(), -1);
+	_conflict_matrix.clear();
+	std::fill(_met_in_group.begin(), _met_in_group.end(), 0);
+	std::fill(_twice_in_group.begin(), _twice_in_group.end(), 0);
+	std::fill(_met_once.begin(), _met_once.end(), 0);
+	std::fill(_met_twice.begin(), _met_twice.end(), 0);
+	std::fill(_group_mask.begin(), _group_mask.end(), 0);
+	std::fill(_tables_size.begin(), _tables_size.end(), 0);
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::init_solution()
+{
 	switch (_init_alg){
 	
 		case sgp::INIT_ALG::RANDOM:
+		{
+			/* every week is a Fisher-Yates shuffle of its free players */
+			const unsigned int n = _g * _p;
+			for(unsigned int w = 0 ; w < _w ; w++){
+				int *week = &_tables[w * n];
+				const unsigned int k = frozen_prefix(w, week);
+				for(unsigned int i = n - k ; i > 1 ; i--)
+					std::swap(week[k + i - 1], week[k + _rng(i)]);
+			}
+			rebuild();
+
+			break;			
+		}
+
+		case sgp::INIT_ALG::GREEDY:
+			greedy_fill(1);
+			rebuild();
+			break;
+	}
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::construct(unsigned int rcl)
+{
+	greedy_fill(rcl);
+	rebuild();
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::save(SGPSnapshot& snap) const
+{
+	snap.tables = _tables;
+	snap.eval = best_eval;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::restore(const SGPSnapshot& snap)
+{
+	if(snap.tables.size() != _tables.size())
+		throw std::invalid_argument("snapshot of another instance");
+
+	/* every week a permutation of the players, before anything changes */
+	const unsigned int n = _g * _p;
+	std::vector<bits::word> placed(_mask_words);
+	for(unsigned int w = 0 ; w < _w ; w++){
+		bits::clear(placed.data(), _mask_words);
+		for(unsigned int i = 0 ; i < n ; i++){
+			const int x = snap.tables[w * n + i];
+			if(	x < 0 || x >= static_cast<int>(n) || 
+				bits::test(placed.data(), x))
+				throw std::invalid_argument("snapshot is not a schedule");
+			bits::set(placed.data(), x);
+		}
+	}
+
+	std::copy(snap.tables.begin(), snap.tables.end(), _tables.begin());
+	rebuild();
+	if(best_eval != snap.eval)
+		throw std::invalid_argument("snapshot eval does not match its schedule");
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::save_state(SGPState& state) const
+{
+	save(state.solution);
+	state.conflicts.assign(conflict_set.begin(), conflict_set.end());
+	_rng.save(state.rng);
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::restore_state(const SGPState& state)
+{
+	restore(state.solution);
+	if(state.conflicts.size() != conflict_set.size())
+		throw std::invalid_argument("conflict cells of another solution");
+	/* every recorded cell is a distinct member */
+	std::vector<bool> seen(_w * _g * _p, false);
+	for(const ConflictSet::cell &c : state.conflicts){
+		if(	c.w >= _w || c.player >= _g * _p || 
+			!conflict_set.contains(c.w, c.player) ||
+			seen[c.w * _g * _p + c.player])
+			throw std::invalid_argument("conflict cells of another solution");
+		seen[c.w * _g * _p + c.player] = true;
+	}
+	conflict_set.reorder(state.conflicts);
+	_rng.restore(state.rng);
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::week_conflicts(unsigned int w) const
+{
+	unsigned int res = 0;
+	for(unsigned int g = 0 ; g < _g ; g++){
+		for(const int *it = group_begin(w, g); it != group_end(w, g); ++it)
+			res += bits::count_and(met_twice(*it), group_mask(w, g), 
+																_mask_words);
+	}
+	return res / 2;
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::met_outside_week(	unsigned int w, 
+									std::vector<bits::word>& rows) const
+{
+	const unsigned int n = _g * _p;
+	rows.resize(n * _mask_words);
+	for(unsigned int x = 0 ; x < n ; x++){
+		/* a meeting in W itself only counts if it happened twice */
+		const bits::word *mask = group_mask(w, _groups[w][x]);
+		const bits::word *once = met_once(x);
+		const bits::word *twice = met_twice(x);
+		bits::word *row = &rows[x * _mask_words];
+		for(unsigned int j = 0 ; j < _mask_words ; j++)
+			row[j] = (once[j] & ~mask[j]) | (twice[j] & mask[j]);
+	}
+}
 
-			std::vector<int> vals;
-			for(unsigned int i = 0 ; i < _g * _p; ++i) 
-			{
-				for(unsigned int j = 0 ; j < _g * _p; ++j){
-				   _conflict_matrix[i][j] = _conflict_matrix[j][i] = 0;	
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::set_week(unsigned int w, const int* players)
+{
+	std::vector<bool> used(_g, false);
+	std::vector<bits::word> target(_mask_words);
+	for(unsigned int j = 0 ; j < _g ; j++){
+		const int *members = players + j * _p;
+
+		/* keep the label of the first member if it is still free */
+		unsigned int g = _groups[w][members[0]];
+		if(used[g])
+			g = std::find(used.begin(), used.end(), false) - used.begin();
+		used[g] = true;
+
+		bits::clear(target.data(), _mask_words);
+		for(unsigned int i = 0 ; i < _p ; i++)
+			bits::set(target.data(), members[i]);
+
+		for(unsigned int i = 0 ; i < _p ; i++){
+			const int x = members[i];
+			const unsigned int gx = _groups[w][x];
+			if(gx == g)
+				continue;
+			const int *y = group_begin(w, g);
+			while(bits::test(target.data(), *y))
+				++y;
+			const int out = *y;
+			set_field(w, g, out, x);
+			set_field(w, gx, x, out);
+		}
+	}
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::perturb(unsigned int swaps)
+{
+	/* pinned groups lead their week: draw from the groups after them */
+	const unsigned int first_week = _first_group[0] == _g ? 1 : 0;
+	if(_g < 2 || first_week >= _w)
+		return;
+	for(unsigned int i = 0 ; i < swaps ; i++){
+		const unsigned int w = first_week + _rng(_w - first_week);
+		const unsigned int first = _first_group[w];
+		if(_g - first < 2)
+			continue;
+		const unsigned int ga = first + _rng(_g - first);
+		unsigned int gb = first + _rng(_g - first - 1);
+		if(gb >= ga)
+			gb++;
+		const int a = group_begin(w, ga)[_rng(_p)];
+		const int b = group_begin(w, gb)[_rng(_p)];
+		set_field(w, ga, a, b);
+		set_field(w, gb, b, a);
+	}
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::rebuild()
+{
+	clear_solution();
+	const unsigned int n = _g * _p;
+
+	/* membership and meeting counts, one pass over every group */
+	for(unsigned int w = 0 ; w < _w ; w++){
+		for(unsigned int g = 0 ; g < _g ; g++){
+			_tables_size[w * _g + g] = _p;
+			const int *members = group_begin(w, g);
+			for(unsigned int i = 0 ; i < _p ; i++){
+				const int a = members[i];
+				_groups[w][a] = g;
+				bits::set(group_mask(w, g), a);
+				for(unsigned int j = 0 ; j < i ; j++){
+					if(_conflict_matrix.inc(a, members[j]) > 1)
+						best_eval++;
 				}
-				vals.push_back(i);
 			}
+		}
+	}
 
-			for(unsigned int w = 0 ; w < _w ; w++){
-			
-				std::vector<int> to_be_inserted_vals(vals);
-				for(unsigned int i = 0 ; i < _g ; i++){
-					
-					//clear the group set
-					_tables[w][i].clear();
-					for(unsigned int j = 0 ; j < _p ; j++){
-						int new_pos = gen_rand(to_be_inserted_vals.size());	
-						set_field(w, i , UNSET, to_be_inserted_vals[new_pos]);
-						to_be_inserted_vals.erase(
-								to_be_inserted_vals.begin() + new_pos);	
+	/* bit rows from the final counts */
+	for(unsigned int x = 0 ; x < n ; x++){
+		const ConflictMatrix::count_type *row = _conflict_matrix.row(x);
+		for(unsigned int y = 0 ; y < n ; y++){
+			if(row[y] >= 1)
+				bits::set(met_once(x), y);
+			if(row[y] >= 2)
+				bits::set(met_twice(x), y);
+		}
+	}
+
+	/* gain tables and conflict set */
+	for(unsigned int w = 0 ; w < _w ; w++){
+		for(unsigned int g = 0 ; g < _g ; g++){
+			for(const int *it = group_begin(w, g); it != group_end(w, g); ++it)
+				gain_member(w, g, *it, 1);
+		}
+		for(unsigned int x = 0 ; x < n ; x++){
+			if(!frozen(w, x) && has_conflict_in_group(w, _groups[w][x], x))
+				conflict_set.insert(w, x);
+		}
+	}
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::greedy_fill(unsigned int rcl)
+{
+	const unsigned int n = _g * _p;
+	const unsigned int nw = _mask_words;
+	_init_rows.resize(2 * nw);
+	_init_conf.resize(n);
+	bits::word *avail = &_init_rows[0];		// players not placed this week
+	bits::word *fresh = avail + nw;			// ... that met no member yet
+	unsigned int *conf = &_init_conf[0];	// members met, kept for AVAIL
+
+	std::fill(_met_once.begin(), _met_once.end(), 0);
+	for(unsigned int w = 0 ; w < _w ; w++){
+		/* pinned groups come first and are taken as they are */
+		const unsigned int prefix = frozen_prefix(w, &_tables[w * n]);
+		bits::clear(avail, nw);
+		for(unsigned int i = prefix ; i < n ; i++)
+			bits::set(avail, _tables[w * n + i]);
+
+		for(unsigned int g = 0 ; g < _g ; g++){
+			int *group = group_begin(w, g);
+			std::copy(avail, avail + nw, fresh);
+			std::fill(conf, conf + n, 0);
+
+			for(unsigned int slot = g < _first_group[w] ? _p : 0 ; 
+					slot < _p ; slot++){
+				/*
+				 * FRESH holds the players of no conflict and the free ones 
+				 * of a candidate X are FRESH minus met(X), so only FRESH is 
+				 * scanned while it holds enough candidates. Otherwise every 
+				 * player left has FREE = 0 (RCL = 1) or is ranked (RCL > 1).
+				 */
+				const unsigned int nfresh = bits::count(fresh, nw);
+				const bits::word *scan = 
+					nfresh > 0 && nfresh >= rcl ? fresh : avail;
+				unsigned int best = 0, best_conf = UINT_MAX, best_free = 0;
+				unsigned int ties = 0;
+				_init_keys.clear();
+				for(unsigned int i = 0 ; i < nw ; i++){
+					for(bits::word rest = scan[i]; rest ; rest &= rest - 1){
+						const unsigned int x = 
+									i * bits::WORD_BITS + __builtin_ctzll(rest);
+						if(rcl <= 1 && conf[x] > best_conf)
+							continue;
+						const unsigned int free = nfresh == 0 ? 0 :
+							nfresh - bits::count_and(fresh, met_once(x), nw);
+						if(rcl > 1){
+							/* rank, then a random tie breaker, then X */
+							_init_keys.push_back(
+								(std::uint64_t(conf[x]) << 48) |
+								(std::uint64_t(n - free) << 32) |
+								((_rng.next() >> 48) << 16) | x);
+						}else if(conf[x] < best_conf || free > best_free){
+							best = x;
+							best_conf = conf[x];
+							best_free = free;
+							ties = 1;
+						}else if(free == best_free && _rng(++ties) == 0){
+							best = x;
+						}
 					}
 				}
-				assert(to_be_inserted_vals.size() == 0 );
+				if(rcl > 1){
+					const unsigned int size = std::min<unsigned int>(
+												rcl, _init_keys.size());
+					std::nth_element(	_init_keys.begin(), 
+										_init_keys.begin() + (size - 1),
+										_init_keys.end());
+					best = _init_keys[_rng(size)] & 0xffff;
+				}
+				group[slot] = best;
+				bits::reset(avail, best);
+				bits::reset(fresh, best);
+				const bits::word *met = met_once(best);
+				for(unsigned int j = 0 ; j < nw ; j++){
+					fresh[j] &= ~met[j];
+					for(bits::word rest = avail[j] & met[j]; rest ; 
+							rest &= rest - 1)
+						conf[j * bits::WORD_BITS + __builtin_ctzll(rest)]++;
+				}
 			}
 
-			break;			
-
+			for(unsigned int i = 0 ; i < _p ; i++){
+				for(unsigned int j = 0 ; j < i ; j++){
+					bits::set(met_once(group[i]), group[j]);
+					bits::set(met_once(group[j]), group[i]);
+				}
+			}
+		}
 	}
 }
 
 /**------------------------------------------------------------------------**/
-void sgp::SGP::inc_conflict(unsigned int w1, unsigned int g1, 
+template<class Dims>
+void sgp::BasicSGP<Dims>::inc_conflict(unsigned int w1, unsigned int g1, 
 							unsigned int p1, unsigned int p2)
 {
 	assert(p1 < _p *_g && p2 < _p * _g);
-	_conflict_matrix[p1][p2] = ++_conflict_matrix[p2][p1];
-	if(_conflict_matrix[p1][p2] > 1){
+	const unsigned int c = _conflict_matrix.inc(p1, p2);
+	gain_pair(p1, p2, c, 1);
+	if(c == 1){
+		bits::set(met_once(p1), p2);
+		bits::set(met_once(p2), p1);
+	}else if(c == 2){
+		bits::set(met_twice(p1), p2);
+		bits::set(met_twice(p2), p1);
+	}
+	if(c > 1){
 		best_eval++;
 		add_conflict(w1, g1, p1);
 		add_conflict(w1, g1, p2);
 	}	
-	if(_conflict_matrix[p1][p2] == 2){
+	if(c == 2){
 		for(unsigned int w = 0; w < _w; w++)
 		{
 			if(w == w1)
 				continue;
 			const int &g1 = _groups[w][p1];
 			const int &g2 = _groups[w][p2];
-			if(g1 != -1 && g1 == g2){
+			/* the only way to a pinned group: its members stay out */
+			if(	g1 != -1 && g1 == g2 && 
+				g1 >= static_cast<int>(_first_group[w])){
 				add_conflict(w, g1, p1);
 				add_conflict(w, g2, p2);
 			}
@@ -251,20 +732,30 @@ void sgp::SGP::inc_conflict(unsigned int w1, unsigned int g1,
 	}
 }
 /**------------------------------------------------------------------------**/
-void sgp::SGP::dec_conflict(unsigned int w1, unsigned int g1, 
+template<class Dims>
+void sgp::BasicSGP<Dims>::dec_conflict(unsigned int w1, unsigned int g1, 
 							unsigned int p1, unsigned int p2)
 {
 	assert(p1 < _p *_g && p2 < _p * _g);
 	remove_conflict(w1, g1, p1);
-	if(_conflict_matrix[p1][p2] > 1){
+	const unsigned int c = _conflict_matrix.dec(p1, p2);
+	gain_pair(p1, p2, c, -1);
+	if(c == 0){
+		bits::reset(met_once(p1), p2);
+		bits::reset(met_once(p2), p1);
+	}else if(c == 1){
+		bits::reset(met_twice(p1), p2);
+		bits::reset(met_twice(p2), p1);
+	}
+	if(c >= 1){
 		best_eval--;
 	}
-	_conflict_matrix[p1][p2] = --_conflict_matrix[p2][p1];
-	if(calc_conflicts_player_in_group(w1, g1, p2) == 0)
+	/* P1 has already left the group mask of <W1, G1> */
+	if(!has_conflict_in_group(w1, g1, p2))
 		remove_conflict(w1, g1, p2);
 
 
-	if(_conflict_matrix[p1][p2] == 1){
+	if(c == 1){
 		for(unsigned int w = 0; w < _w; w++)
 		{
 			if(w == w1)
@@ -272,9 +763,9 @@ void sgp::SGP::dec_conflict(unsigned int w1, unsigned int g1,
 			const int &g1 = _groups[w][p1];
 			const int &g2 = _groups[w][p2];
 			if(g1 != -1 && g1 == g2){
-				if(calc_conflicts_player_in_group(w, g1, p1) == 0)
+				if(!has_conflict_in_group(w, g1, p1))
 					remove_conflict(w, g1, p1);
-				if(calc_conflicts_player_in_group(w, g2, p2) == 0)
+				if(!has_conflict_in_group(w, g2, p2))
 					remove_conflict(w, g2, p2);
 			}
 		}
@@ -282,25 +773,40 @@ void sgp::SGP::dec_conflict(unsigned int w1, unsigned int g1,
 }
 
 /**------------------------------------------------------------------------**/
-void sgp::SGP::add_conflict(unsigned int w, unsigned int g, unsigned int val){
+template<class Dims>
+void sgp::BasicSGP<Dims>::add_conflict(	unsigned int w, unsigned int g, 
+										unsigned int val){
 
 	assert(w < _w && g < _g);
-	decision elem(w, g, val);
-	auto iter = conflict_set.get<0>().insert(conflict_set.end(),std::move( elem ));
-	iter->erased = false;
+	assert(!frozen(w, val));
+	conflict_set.insert(w, val);
 }
 /**------------------------------------------------------------------------**/
-void sgp::SGP::remove_conflict(unsigned int w, 	unsigned int g, 
+template<class Dims>
+void sgp::BasicSGP<Dims>::remove_conflict(unsigned int w, 	unsigned int g, 
 												unsigned int val){
 
-	decision elem(w, g, val);
-	auto iter = conflict_set.find(std::move( elem ));
-	if(iter != conflict_set.end()){
-		iter->erased = true;
+	const int &cur = _groups[w][val];
+	if(cur == -1 || cur == static_cast<int>(g)){
+		conflict_set.erase(w, val);
+	}
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::refresh_conflict(unsigned int w, unsigned int player)
+{
+	const int &g = _groups[w][player];
+	assert(!frozen(w, player));
+	if(g != -1 && has_conflict_in_group(w, g, player)){
+		conflict_set.insert(w, player);
+	}else{
+		conflict_set.erase(w, player);
 	}
 }
 /**------------------------------------------------------------------------**/
-void sgp::SGP::set_field(	unsigned int w,	
+template<class Dims>
+void sgp::BasicSGP<Dims>::set_field(	unsigned int w,	
 							unsigned int g,	
 							int old_val, 
 							int new_val)
@@ -315,20 +821,28 @@ void sgp::SGP::set_field(	unsigned int w,
 		return;
 	}
 
+	unsigned int &size = _tables_size[w * _g + g];
+	int *slot = nullptr;
 	if(old_val == UNSET){
 		//we expect a new insertion
-		logger().debug("<%d, %d> .size= %d", w, g, _tables[w][g].size());
-		assert(_tables[w][g].size() < _p );
+		SGP_DEBUG(logger(), "<%d, %d> .size= %d", w, g, size);
+		assert(size < _p );
 	}else{
-		assert(_tables[w][g].size() == _p);
-		_groups[w][old_val] = -1;
+		assert(size == _p);
+		slot = std::find(group_begin(w, g), group_end(w, g), old_val);
+		if(slot == group_end(w, g)){
+			SGP_ERROR(logger(), "false insertion: %d is not in <%d, %d> "
+						"(replacing it with %d)", old_val, w, g, new_val);
+		}
+		assert(slot != group_end(w, g));
+		/* OLD_VAL leaves the week unless it was already moved elsewhere */
+		if(_groups[w][old_val] == static_cast<int>(g))
+			leave_group(w, g, old_val);
 	}
 
-	for(const int& p2 : _tables[w][g] ){
-
-		if(p2 == UNSET)
-			continue;
+	for(const int *it = group_begin(w, g); it != group_end(w, g); ++it){
 
+		const int &p2 = *it;
 		if(old_val != UNSET){
 			if(p2 == old_val)
 				continue;
@@ -340,47 +854,86 @@ void sgp::SGP::set_field(	unsigned int w,
 		inc_conflict(w, g, new_val,p2);
 	}//END_FOR
 
-	
-	_tables[w][g].insert(std::move(new_val));
-	_groups[w][new_val] = g;
 
-	if(old_val != UNSET){	
-	
-		//remove_conflict(w, g, old_val);	
-
-		size_t cnt = _tables[w][g].erase(std::move(old_val));
-		if(cnt == 0){
-			std::cout << "FALSE INSERTION: in " << w <<" " << g << " " << 
-																" " << old_val 
-																<< "with " 
-																<< new_val 
-																<< std::endl;
-			std::cout << *this;
-		}
-		assert(cnt == 1);
+	if(slot != nullptr){
+		*slot = new_val;		// replace OLD_VAL in place
+	}else{
+		group_begin(w, g)[size++] = new_val;
+	}
+	if(_groups[w][new_val] != -1){
+		/* NEW_VAL is swapped in from another group of this week */
+		leave_group(w, _groups[w][new_val], new_val);
 	}
+	join_group(w, g, new_val);
 
+	/* OLD_VAL was swapped into another group: fix its conflict cell */
+	if(old_val != UNSET && _groups[w][old_val] != -1){
+		refresh_conflict(w, old_val);
+	}
 }
 
 /**------------------------------------------------------------------------**/
-double sgp::gen_rand()
+template<class Dims>
+void sgp::BasicSGP<Dims>::join_group(	unsigned int w, unsigned int g, 
+										unsigned int player)
 {
-	
-	static std::random_device rdev{};
-	static std::default_random_engine e(rdev());
-	static std::uniform_real_distribution<double> d(0.0, 1.0);
+	_groups[w][player] = g;
+	bits::set(group_mask(w, g), player);
+	gain_member(w, g, player, 1);
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::leave_group(	unsigned int w, unsigned int g, 
+										unsigned int player)
+{
+	assert(_groups[w][player] == static_cast<int>(g));
+	_groups[w][player] = -1;
+	bits::reset(group_mask(w, g), player);
+	gain_member(w, g, player, -1);
+}
 
-	return d(e);
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::gain_member(	unsigned int w, unsigned int g, 
+							unsigned int player, int sign)
+{
+	const unsigned int n = _g * _p;
+	const ConflictMatrix::count_type *row = _conflict_matrix.row(player);
+	unsigned short *met = &_met_in_group[(w * _g + g) * n];
+	unsigned short *twice = &_twice_in_group[(w * _g + g) * n];
+	for(unsigned int x = 0 ; x < n ; ++x){
+		met[x] += sign * (row[x] >= 1);
+		twice[x] += sign * (row[x] >= 2);
+	}
 }
 
 /**------------------------------------------------------------------------**/
-unsigned int sgp::gen_rand(unsigned int n)
+template<class Dims>
+void sgp::BasicSGP<Dims>::gain_pair(	unsigned int p1, unsigned int p2, 
+							unsigned int count, int delta)
 {
-	return static_cast<unsigned int>(gen_rand() * n);
+	/* only crossing the 0/1 or 1/2 boundary changes a gain */
+	const unsigned int level = delta > 0 ? count : count + 1;
+	if(level > 2)
+		return;
+	std::vector<unsigned short> &table = 
+						level == 1 ? _met_in_group : _twice_in_group;
+	const unsigned int n = _g * _p;
+	for(unsigned int w = 0 ; w < _w ; w++){
+		const int &g1 = _groups[w][p1];
+		const int &g2 = _groups[w][p2];
+		if(g2 != -1)
+			table[(w * _g + g2) * n + p1] += delta;
+		if(g1 != -1)
+			table[(w * _g + g1) * n + p2] += delta;
+	}
 }
 
 /**------------------------------------------------------------------------**/
-int sgp::SGP::calc_conflicts_diff_in_group(	unsigned int w,	unsigned int g, 
+template<class Dims>
+int sgp::BasicSGP<Dims>::calc_conflicts_diff_in_group(	unsigned int w,	
+														unsigned int g, 
 														int old_val, 
 														int new_val)
 {
@@ -388,29 +941,23 @@ int sgp::SGP::calc_conflicts_diff_in_group(	unsigned int w,	unsigned int g,
 	if(old_val == new_val)
 		return 0;
 	
-	int res = 0;
-	for(const int& p2 : _tables[w][g]){
-		
-		if(p2 != old_val){
-			if(_conflict_matrix[old_val][p2] > 1){  
-				res--;		
-			}
-		
-			if(_conflict_matrix[new_val][p2] >= 1){  
-				res++;
-			}
-		}
-	}
-
-	return res;	
+	/* bit-parallel over the members; OLD_VAL has never met itself */
+	const bits::word *members = group_mask(w, g);
+	return 	static_cast<int>(
+				bits::count_and(met_once(new_val), members, _mask_words)) -
+			static_cast<int>(bits::test(met_once(new_val), old_val)) -
+			static_cast<int>(
+				bits::count_and(met_twice(old_val), members, _mask_words));
 }
 
 
 /**------------------------------------------------------------------------**/
-unsigned int sgp::SGP::calc_conflicts_player(int player)
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::calc_conflicts_player(int player)
 {
-	return accumulate(	_conflict_matrix[player].begin(), 
-						_conflict_matrix[player].end() , 
+	const ConflictMatrix::count_type *row = _conflict_matrix.row(player);
+	return std::accumulate(	row, 
+						row + _conflict_matrix.size() , 
 						0,
 						[](int x, int y)
 								{return x + std::max(y - 1, 0);} 
@@ -418,157 +965,199 @@ unsigned int sgp::SGP::calc_conflicts_player(int player)
 }
 
 /**------------------------------------------------------------------------**/
-unsigned int sgp::SGP::calc_conflicts_player_in_group(	unsigned int w,
+template<class Dims>
+unsigned int sgp::BasicSGP<Dims>::calc_conflicts_player_in_group(	unsigned int w,
 														unsigned int g,
 														unsigned int player)
 {
-	return accumulate(	_tables[w][g].begin(), 
-						_tables[w][g].end() , 
+	const ConflictMatrix::count_type *row = _conflict_matrix.row(player);
+	return std::accumulate(	group_begin(w, g), 
+						group_end(w, g) , 
 						0,
 						[&](int x, int y)
 								{return x + 
 										std::max(
-											_conflict_matrix[y][player] - 1,
+											row[y] - 1,
 												0);} 
 					);
 }
 
 
 /**------------------------------------------------------------------------**/
-int sgp::SGP::get_eval() const
+template<class Dims>
+int sgp::BasicSGP<Dims>::get_eval() const
 {
 	return best_eval;
 }
 
 /**------------------------------------------------------------------------**/
-void sgp::SGP::local_search(SGPTabuList& tabu, unsigned int best_eval)
+template<class Dims>
+void sgp::BasicSGP<Dims>::collect_moves(	SGPTabuList& tabu, 
+								unsigned int begin, unsigned int end,
+								MoveBatch& batch)
+{
+	const unsigned int n = _g * _p;
+	batch.clear();
+	for(unsigned int i = begin ; i < end ; ++i)
+	{
+		const ConflictSet::cell &c = conflict_set[i];
+		const unsigned int w = c.w;
+		const unsigned int a = c.player;
+		const unsigned int ga = _groups[w][a];
+		assert(ga >= _first_group[w]);	/* pinned cells never conflict */
+		const SwapRows rows = {	&_met_in_group[w * _g * n], 
+								&_twice_in_group[w * _g * n],
+								met_once(a), _groups[w].data(), n, a, ga};
+
+		/**
+		 * the members of the unpinned groups but A's, in table order: 
+		 * the slots before and after A's group (all groups are full)
+		 */
+		const unsigned int ranges[2][2] = {
+				{_first_group[w] * _p, ga * _p}, {(ga + 1) * _p, n}};
+		for(const auto &range : ranges){
+			if(range[0] >= range[1])
+				continue;
+			const unsigned int count = range[1] - range[0];
+			const unsigned int at = batch.grow(count);
+			const int *members = &_tables[w * n + range[0]];
+			std::copy(members, members + count, &batch.player[at]);
+			std::fill(&batch.cell[at], &batch.cell[at] + count, i);
+			kernel::score_swaps(rows, members, count, &batch.diff[at]);
+			tabu.tabu_mask(w, a, members, count, &batch.tabu[at]);
+		}
+	}
+}
+
+/**------------------------------------------------------------------------**/
+template<class Dims>
+void sgp::BasicSGP<Dims>::local_search(SGPTabuList& tabu, unsigned int best_eval)
 {
-	logger().debug("check--");
+	SGP_DEBUG(logger(), "check--");
 	if(this->best_eval == 0){
 		return;
 	}
 	// best difference found so far
 	int best_diff = best_eval - this->best_eval;
-	const decision *chosed_conflict = nullptr;	
-	
-	decision chosed_decision(0 , 0 , 0);
-									// stores the decision value 
-									// corresponding to best_diff
-	int chosed_diff = INT_MAX;		// best NON_TABU difference 
-									//chosen so far
-
-	
 
-	for(	auto s1 = conflict_set.begin() ; 
-				s1 != conflict_set.end() ; 
-				s1++ )
-	{
-
-		/* Clean the list from Decisions whose conflicts is 0 */
-		while( 	 s1->erased ){
-			logger().debug("erased (%d, %d, %d)", s1->w , s1->g, s1->val);
-			s1 = conflict_set.erase(s1);
-			if(s1 == conflict_set.end())
-				return;
+	const MoveBatch *tabu_batch = &_batch;
+	const MoveBatch *free_batch = &_batch;
+	MoveChoice choice;
+	const unsigned int cells = conflict_set.size();
+	if(	_workers != nullptr && _workers->threads() > 1 &&
+		cells * (_g - 1) * _p >= PARALLEL_SCAN_MIN_MOVES){
+		const unsigned int chunks = std::min(cells, _workers->threads());
+		_batches.resize(chunks);
+		_choices.resize(chunks);
+		_workers->run(chunks, [&](unsigned int t){
+			collect_moves(	tabu, cells * t / chunks, cells * (t + 1) / chunks,
+							_batches[t]);
+			_choices[t] = kernel::best_moves(	_batches[t].diff.data(),
+												_batches[t].tabu.data(),
+												_batches[t].size());
+		});
+		if(_stats != nullptr){
+			for(unsigned int t = 0 ; t < chunks ; t++)
+				_stats->moves_evaluated += _batches[t].size();
 		}
-		
-		logger().debug("----------------------------------");
-		logger().debug("selected conflict <%d, %d, [%d]>", s1->w, s1->g, s1->val);
-		for(unsigned int g = 0 ; g < _g; g++ )
-		{		
-			if(g == s1->g )
-				continue;		// skip s1's group
-			for(const int &new_val : _tables[s1->w][g])
-			{		
-			
-				//std::cin.get();	
-				logger().debug("\ninspecting <%d, %d,[%d]", s1->w , g, new_val);
-				int g1_diff = calc_conflicts_diff_in_group( 	s1->w, 	s1->g, 
-																s1->val, 
-																new_val);	
-				logger().debug("g1_diff = %d", g1_diff);
-				int g2_diff = calc_conflicts_diff_in_group( s1->w, g, new_val, 
-																	s1->val);	
-				logger().debug("g2_diff = %d", g2_diff);
-
-				int diff = g1_diff + g2_diff;
-				logger().debug("diff = %d", diff);
-
-				if(	diff <= chosed_diff &&
-					!tabu.is_tabu( s1->w, s1->val, new_val ) )
-				{
-					logger().debug("found non-tabu %d, %d, %d",
-										s1->w, g, new_val);
-					chosed_diff = diff;
-					chosed_decision.w = s1->w;
-					chosed_decision.g = g;
-					chosed_decision.val = new_val;
-
-					chosed_conflict = &*s1;
-					if(chosed_diff < best_diff){
-						best_diff = chosed_diff;
-					}
-				}
-				else if( diff < best_diff) /** update aspiration */
-				{
-					best_diff = diff;
-					chosed_diff = diff;
-					chosed_decision.w = s1->w;
-					chosed_decision.g = g;
-					chosed_decision.val = new_val;
-					chosed_conflict = &*s1;
-					logger().debug("found aspiration %d, %d, [%d]", 
-														chosed_decision.w,
-														chosed_decision.g,
-														chosed_decision.val);
-				}
-				
-				logger().debug("chosed_diff is %d", chosed_diff);
-				logger().debug("best_diff is %d", best_diff);
-				logger().debug("best_eval is %d", this->best_eval);
+
+		/** 
+		 * chunks cover the cells in order, so keeping the first of equal
+		 * moves makes the same choice as a serial scan
+		 */
+		choice = MoveChoice{INT_MAX, -1, INT_MAX, -1};
+		for(unsigned int t = 0 ; t < chunks ; t++){
+			const MoveChoice &c = _choices[t];
+			if(c.tabu_idx != -1 && c.tabu_diff < choice.tabu_diff){
+				choice.tabu_diff = c.tabu_diff;
+				choice.tabu_idx = c.tabu_idx;
+				tabu_batch = &_batches[t];
+			}
+			if(c.free_idx != -1 && c.free_diff < choice.free_diff){
+				choice.free_diff = c.free_diff;
+				choice.free_idx = c.free_idx;
+				free_batch = &_batches[t];
 			}
 		}
+	}else{
+		collect_moves(tabu, 0, cells, _batch);
+		choice = kernel::best_moves(	_batch.diff.data(), 
+										_batch.tabu.data(),
+										_batch.size());
+		if(_stats != nullptr)
+			_stats->moves_evaluated += _batch.size();
 	}
-
-	if(chosed_diff == INT_MAX){
+	if(_stats != nullptr)
+		_stats->peak_conflicts = std::max<std::size_t>(	_stats->peak_conflicts,
+														cells);
+
+	int chosen;
+	const MoveBatch *batch;
+	if(	choice.tabu_idx != -1 && choice.tabu_diff < best_diff &&
+		choice.tabu_diff < choice.free_diff)	/** aspiration */
+	{
+		chosen = choice.tabu_idx;
+		batch = tabu_batch;
+		SGP_TRACE(logger(), "found aspiration %d", choice.tabu_diff);
+		if(_stats != nullptr)
+			_stats->aspirations++;
+	}else if(choice.free_idx != -1){
+		chosen = choice.free_idx;
+		batch = free_batch;
+		if(	_stats != nullptr && choice.tabu_idx != -1 && 
+			choice.tabu_diff < choice.free_diff)
+			_stats->tabu_rejections++;
+	}else{
+		if(_stats != nullptr && choice.tabu_idx != -1)
+			_stats->tabu_rejections++;
 		return;
 	}
 
-	assert( chosed_conflict != nullptr);
-	assert(	chosed_decision.w == chosed_conflict->w &&
-			chosed_decision.g != chosed_conflict->g && 
-			chosed_decision.val != chosed_conflict->val);
+	const int chosed_diff = batch->diff[chosen];
+	const ConflictSet::cell &c = conflict_set[batch->cell[chosen]];
+	const decision chosed_conflict(c.w, _groups[c.w][c.player], c.player);
+	const unsigned int new_val = batch->player[chosen];
+	const decision chosed_decision(c.w, _groups[c.w][new_val], new_val);
+	if(chosed_diff < best_diff){
+		best_diff = chosed_diff;
+	}
+	SGP_DEBUG(logger(), "chosed_diff is %d", chosed_diff);
+	SGP_DEBUG(logger(), "best_diff is %d", best_diff);
+	SGP_DEBUG(logger(), "best_eval is %d", this->best_eval);
+
+	assert(	chosed_decision.w == chosed_conflict.w &&
+			chosed_decision.g != chosed_conflict.g && 
+			chosed_decision.val != chosed_conflict.val);
 
 	/* Add to tabu list*/
-	tabu.add(chosed_decision.w, chosed_conflict->val , chosed_decision.val); 
+	tabu.add(chosed_decision.w, chosed_conflict.val , chosed_decision.val); 
 	//swap the values
-	logger().debug("swapped (%d, %d [%d])with (%d, %d, [%d] )", 
-				chosed_conflict->w, chosed_conflict->g, chosed_conflict->val, 
+	SGP_TRACE(logger(), "swapped (%d, %d [%d])with (%d, %d, [%d] )", 
+				chosed_conflict.w, chosed_conflict.g, chosed_conflict.val, 
 				chosed_decision.w , 
 				chosed_decision.g, chosed_decision.val);
 
-	_groups[chosed_conflict->w][chosed_conflict->val] = -1;
-	_groups[chosed_decision.w][chosed_decision.val] = -1;
-
 	int eval_before = this->best_eval;
-	set_field( 	chosed_conflict->w, chosed_conflict->g, chosed_conflict->val, 
+	set_field( 	chosed_conflict.w, chosed_conflict.g, chosed_conflict.val, 
 														chosed_decision.val);
 	set_field(	chosed_decision.w, chosed_decision.g, 
 									chosed_decision.val,
-									chosed_conflict->val);
+									chosed_conflict.val);
 	int eval_after = this->best_eval;
 
 	if(chosed_diff != eval_after - eval_before){
-		std::cout << *this;
+		SGP_ERROR(logger(), "swap changed the eval by %d, scored %d", 
+									eval_after - eval_before, chosed_diff);
 	}
 	assert( chosed_diff == (eval_after - eval_before));	
 	best_diff -= (eval_after - eval_before);
-	logger().debug("eval_before is %d", eval_before);
-	logger().debug("eval_after is %d", eval_after);
-	logger().debug("best_diff is %d", best_diff);
+	SGP_DEBUG(logger(), "eval_before is %d", eval_before);
+	SGP_DEBUG(logger(), "eval_after is %d", eval_after);
+	SGP_DEBUG(logger(), "best_diff is %d", best_diff);
 
 
-	logger().debug("CONFLICT list includes %d members: ", conflict_set.size());
+	SGP_DEBUG(logger(), "CONFLICT list includes %d members: ", 
+										static_cast<int>(conflict_set.size()));
 	/*std::for_each(	conflict_set.begin(), conflict_set.end() , 
 					[&] (const decision d) 
 						{ logger().debug(" (%d, %d, %d) ", d.w, d.g, d.p); });
@@ -577,3 +1166,13 @@ void sgp::SGP::local_search(SGPTabuList& tabu, unsigned int best_eval)
 
 	
 
+/**------------------------------------------------------------------------**/
+#define SGP_INSTANTIATE(G, P, W) 										\
+	template class sgp::BasicSGP<sgp::FixedDims<G, P, W>>;				\
+	template std::ostream& sgp::operator<< (	std::ostream&, 			\
+						const sgp::BasicSGP<sgp::FixedDims<G, P, W>>&);
+
+template class sgp::BasicSGP<sgp::DynamicDims>;
+template std::ostream& sgp::operator<< (	std::ostream&, 
+									const sgp::BasicSGP<sgp::DynamicDims>&);
+SGP_FIXED_INSTANCES(SGP_INSTANTIATE)
@@ -6,13 +6,17 @@
 #include <stdexcept>
 #include <string>
 #include "log4cpp/Category.hh"
+#include "log.hh"
 #include <climits>
 #include <map>
 #include <iterator>
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/identity.hpp>
-#include <boost/multi_index/member.hpp>
+#include "bits.hh"
+#include "conflict_matrix.hh"
+#include "conflict_set.hh"
+#include "kernel.hh"
+#include "random.hh"
+#include "dims.hh"
+#include "workers.hh"
 
 namespace sgp{
 
@@ -20,6 +24,21 @@ const int UNSET = -1;
 	
 enum class INIT_ALG {
 	RANDOM,
+	/* freedom-based greedy construction (Triska & Musliu) */
+	GREEDY
+};
+
+/**
+ * Symmetry breaking: pinned cells are set by init_solution and never
+ * moved by local_search or perturb.
+ * FIRST_WEEK pins week 0 to the canonical partition (0 .. P-1, 
+ * P .. 2P-1, ...); FIRST_WEEK_AND_GROUP also pins the first group of 
+ * week 1 to (0, P, 2P, ...).
+ */
+enum class SYMMETRY {
+	NONE,
+	FIRST_WEEK,
+	FIRST_WEEK_AND_GROUP
 };
 
 enum class SEL_ALG {
@@ -27,10 +46,8 @@ enum class SEL_ALG {
 	RANDOM_CONFLICT
 };
 
-double gen_rand();
-unsigned int gen_rand(unsigned int n);
-
 class SGPTabuList;
+struct SearchStats;
 
 #ifdef TEST	
 #include "gtest/gtest_prod.h"
@@ -41,8 +58,6 @@ struct decision{
 	unsigned int w;
 	unsigned int g;
 	unsigned int val;
-	/* mark this decision as erased and to-be-discard*/
-	mutable bool erased;	
 	decision(unsigned int w, unsigned int g, unsigned int val);
 	friend bool operator < (const decision& lhs, const decision& rhs);
 	friend bool operator == (const decision& lhs, const decision& rhs);
@@ -59,68 +74,262 @@ class decisionHash{
 };
 
 
-class SGP{
+/**
+ * Compact copy of a complete solution: the members of every group in the
+ * week-major layout of BasicSGP::_tables (W * N players) and its eval.
+ */
+struct SGPSnapshot{
+	std::vector<int> tables;
+	int eval = INT_MAX;
+};
+
+/**
+ * Everything local search needs to continue from a solution exactly as 
+ * it would have: the solution, the order of the conflict set (moves are
+ * scanned in that order) and the state of the random generator.
+ */
+struct SGPState{
+	SGPSnapshot solution;
+	std::vector<ConflictSet::cell> conflicts;
+	std::uint64_t rng[4];
+};
+
+template<class Dims> class BasicSGP;
+
+template<class Dims>
+std::ostream& operator<<(std::ostream& os, const BasicSGP<Dims>& sgp);
+
+/**
+ * SGP instance and its incremental conflict bookkeeping.
+ * DIMS (dims.hh) supplies the dimensions, either at run time 
+ * (SGP = BasicSGP<DynamicDims>) or as compile-time constants 
+ * (FixedSGP<G, P, W>).
+ */
+template<class Dims>
+class BasicSGP : private Dims{
 	
   public:
-	SGP(unsigned int g, unsigned int p, unsigned int w);
-	SGP(const SGP& sgp);
-	SGP& operator=(SGP& other);
+	BasicSGP(unsigned int g, unsigned int p, unsigned int w);
+	BasicSGP(const BasicSGP& sgp);
+	BasicSGP(BasicSGP&& sgp) noexcept;
+	BasicSGP& operator=(const BasicSGP& other);
+	BasicSGP& operator=(BasicSGP&& other) noexcept;
+
+	/* true if the dimensions are compile-time constants */
+	using Dims::FIXED;
 
 	unsigned int g() const;
 	unsigned int p() const;
 	unsigned int w() const;
 	std::string get_conflict_matrix_str() const; //TODO: add move semantic
 	void set_init_alg(INIT_ALG alg);
+	INIT_ALG init_alg() const;
+	/**
+	 * Takes effect at the next init_solution or construct.
+	 * Throws std::invalid_argument for FIRST_WEEK_AND_GROUP if P > G,
+	 * where the pinned group cannot exist.
+	 */
+	void set_symmetry(SYMMETRY mode);
+	SYMMETRY symmetry() const;
+	/* Number of leading groups of week W that are pinned */
+	unsigned int frozen_groups(unsigned int w) const;
+	/**
+	 * Writes the pinned players of week W in group order to WEEK[0 .. K)
+	 * and the other players in increasing order to WEEK[K .. N); 
+	 * returns K = frozen_groups(W) * P.
+	 */
+	unsigned int frozen_prefix(unsigned int w, int* week) const;
+	/* Restarts the generator used by init_solution from SEED */
+	void seed(std::uint64_t seed);
+	Random& rng();
+	/**
+	 * Splits the move scan of local_search across POOL once the 
+	 * neighbourhood is large enough; the chosen move is the one a serial
+	 * scan would choose. nullptr (the default) scans serially.
+	 * The pool is not copied along with the instance.
+	 */
+	void set_worker_pool(WorkerPool* pool);
+	/**
+	 * local_search adds its counters to STATS (moves evaluated, tabu
+	 * rejections, aspirations, peak conflict set size); nullptr (the
+	 * default) turns that off. Not copied along with the instance.
+	 */
+	void set_stats(SearchStats* stats);
 	int get_eval() const;
 	void init_solution();	
+	/* Records the current solution into SNAP, reusing its storage */
+	void save(SGPSnapshot& snap) const;
+	/**
+	 * Rebuilds the solution recorded in SNAP, conflict bookkeeping
+	 * included. Throws std::invalid_argument, leaving the instance as 
+	 * it was, for a snapshot of an instance of other dimensions or a
+	 * week that is not a permutation of the players; throws it after 
+	 * the rebuild if the eval of SNAP is not that of its schedule.
+	 */
+	void restore(const SGPSnapshot& snap);
+	/* Records the solution, conflict set order and generator in STATE */
+	void save_state(SGPState& state) const;
+	/**
+	 * Continues from STATE: the solution is rebuilt in bulk as by 
+	 * restore(), then the conflict set takes the recorded order.
+	 * Throws std::invalid_argument for a state of an instance of other
+	 * dimensions or whose conflict cells do not match its solution.
+	 */
+	void restore_state(const SGPState& state);
+	/**
+	 * Builds a solution with the randomized greedy heuristic: every slot
+	 * takes a player drawn uniformly from the RCL best candidates 
+	 * (see greedy_fill). RCL = 1 is the construction of INIT_ALG::GREEDY.
+	 */
+	void construct(unsigned int rcl);
+	/**
+	 * Conflicts caused by week W: the meetings of its groups that 
+	 * repeat a meeting of another week. Rearranging week W alone changes
+	 * get_eval() by exactly the change of this count.
+	 */
+	unsigned int week_conflicts(unsigned int w) const;
+	/**
+	 * Fills ROWS with one bit row (bits::words(N) words) per player: 
+	 * bit Y of row X is set iff X and Y meet in some week other than W.
+	 */
+	void met_outside_week(unsigned int w, std::vector<bits::word>& rows) const;
+	/**
+	 * Rearranges week W into the partition PLAYERS (N players, P per 
+	 * group, groups in order) by swaps through set_field, so the 
+	 * bookkeeping is updated incrementally. Group labels are reused 
+	 * where possible to keep the number of swaps low.
+	 */
+	void set_week(unsigned int w, const int* players);
+	/* Applies SWAPS random swaps of players between groups of a week */
+	void perturb(unsigned int swaps);
 	void local_search(class SGPTabuList& tabu, unsigned int best_eval);
 
   private:
-	unsigned int _g; 	// 	#Groups
-	unsigned int _p; 	// 	#Players
-	unsigned int _w;	//	#Weeks
+	using Dims::_g; 	// 	#Groups
+	using Dims::_p; 	// 	#Players
+	using Dims::_w;		//	#Weeks
+	using Dims::_mask_words;
 	
 	int best_eval = INT_MAX;
 	
 	/**
-	*	Multi-index hash set for storing DECISIONS
-	*	Ordered uniquely by operator <
-	*	Ordered secondairly by W
-	*/
-	typedef boost::multi_index_container<
-	decision,
-	boost::multi_index::indexed_by<
-			boost::multi_index::ordered_unique< 
-				boost::multi_index::identity<decision> >,
-				/*	ordered by operator< */
-			boost::multi_index::ordered_non_unique< 
-				boost::multi_index::member<	decision , 	unsigned int , 
-														&decision::w> >	
-		>
-	> multi_index_decision_set;
-
-	
-	std::vector<std::vector<std::set<int>>> _tables;
+	 *	Flat, week-major group storage.
+	 *	Members of <W, G> are stored in the P slots starting at
+	 *	_tables[(W * _g + G) * _p], the first _tables_size[W * _g + G]
+	 *	of which are in use.
+	 */
+	std::vector<int> _tables;
+	std::vector<unsigned int> _tables_size;
 	std::vector<std::vector<int>> _groups;
-	std::vector<std::vector<int>> _conflict_matrix;
-	std::vector<bool> is_in_conflict_set;
+	ConflictMatrix _conflict_matrix;
+	/**
+	 *	Per-week gain tables, kept up to date by set_field, from which the
+	 *	conflict difference of any swap is read in O(1) (calc_swap_diff).
+	 *	For player X and group <W, G>, _met_in_group[(W * _g + G) * N + X]
+	 *	counts the members of <W, G> (other than X) that X has met at
+	 *	least once; _twice_in_group counts those met at least twice.
+	 */
+	std::vector<unsigned short> _met_in_group;
+	std::vector<unsigned short> _twice_in_group;
+	/**
+	 *	Bit rows kept next to the counts: bit Y of met_once(X) is set iff 
+	 *	X and Y have met at least once, of met_twice(X) iff at least twice.
+	 *	group_mask(W, G) holds the members of <W, G> as recorded in _groups.
+	 */
+	std::vector<bits::word> _met_once;
+	std::vector<bits::word> _met_twice;
+	std::vector<bits::word> _group_mask;
 	INIT_ALG _init_alg = INIT_ALG::RANDOM;
-	//std::unordered_set<decision, decisionHash> conflict_set;
-	multi_index_decision_set conflict_set;
+	SYMMETRY _symmetry = SYMMETRY::NONE;
+	/**
+	 * Pinned cells: bit X of _frozen[W * _mask_words ..] is set iff 
+	 * player X may not move in week W. Pinned cells are whole groups 
+	 * at the start of a week: groups [0, _first_group[W]).
+	 * Pinned cells never enter conflict_set (rebuild filters them and 
+	 * set_field never touches them) and collect_moves starts at 
+	 * _first_group[W], so the scan needs no test for them.
+	 */
+	std::vector<bits::word> _frozen;
+	std::vector<unsigned int> _first_group;
+	/* cells <W, PLAYER> whose player has a conflict in its group */
+	ConflictSet conflict_set;
+	/* scratch buffer of local_search, never copied */
+	MoveBatch _batch;
+	/* scratch rows, counts and keys of greedy_fill, never copied */
+	std::vector<bits::word> _init_rows;
+	std::vector<unsigned int> _init_conf;
+	std::vector<std::uint64_t> _init_keys;
+	/* parallel scan: one batch and choice per chunk, never copied */
+	WorkerPool* _workers = nullptr;
+	/* counters of local_search, never copied */
+	SearchStats* _stats = nullptr;
+	std::vector<MoveBatch> _batches;
+	std::vector<MoveChoice> _choices;
+	/* smallest neighbourhood worth splitting across the worker pool */
+	static const unsigned int PARALLEL_SCAN_MIN_MOVES = 4096;
+	/**
+	 * Copied by the constructors but not by the assignments, which 
+	 * transfer the solution only: assigning a saved solution must not 
+	 * rewind the random stream, while a new instance has no stream of 
+	 * its own yet. Neither transfers the pool, the stats or scratch.
+	 */
+	Random _rng;
 
-	friend std::ostream& operator<<(std::ostream& os, const SGP& sgp);
+	friend std::ostream& operator<< <>(std::ostream& os, const BasicSGP& sgp);
 #ifdef TEST
 	FRIEND_TEST(SGPTest, SET_FIELD);
 	FRIEND_TEST(SGPTest, CALC_CONFLICTS);
 	FRIEND_TEST(SGPTest, INIT_TEST);
+	FRIEND_TEST(SGPTest, CONFLICT_SET);
+	FRIEND_TEST(SGPTest, SWAP_DIFF);
+	FRIEND_TEST(SGPTest, GREEDY);
+	FRIEND_TEST(SGPTest, SYMMETRY);
+	FRIEND_TEST(SGPTest, SNAPSHOT);
+	FRIEND_TEST(SGPTest, REBUILD);
+	FRIEND_TEST(SGPTest, PARALLEL_SCAN);
 	friend class SGPTest;
 #endif
+#ifdef BENCH
+	friend class SGPBench;
+#endif
 	
 	
+	/* Empties all groups and resets the conflict bookkeeping in place */
+	void 
+	clear_solution();
+
+	/**
+	 * Recomputes groups, masks, the conflict matrix, gain tables, 
+	 * conflict set and eval from _tables in one bulk pass.
+	 * PRE-CONDITION: every group in _tables is complete
+	 */
+	void 
+	rebuild();
+
+	/**
+	 * Fills _tables week by week with the greedy heuristic of Triska and
+	 * Musliu: every slot of a group takes the remaining player that has 
+	 * met the fewest of its members, and among those the one leaving the 
+	 * most remaining players free to join the group (players that have 
+	 * met none of its members). Ties are broken at random.
+	 * With RCL > 1 the player is drawn uniformly from the RCL best 
+	 * candidates instead (restricted candidate list of GRASP).
+	 * Uses _met_once as the meeting table of the weeks built so far;
+	 * the caller must rebuild() afterwards.
+	 * The members met by each remaining player are counted as the group
+	 * fills, and only the players of no conflict are scored while they
+	 * suffice, one popcount pass each. A week still costs up to
+	 * O(N * N * N / 64) word operations while few pairs have met, about
+	 * 6 times the random construction on 20-20-20.
+	 * PRE-CONDITION: N < 65536
+	 */
+	void 
+	greedy_fill(unsigned int rcl);
+
 	/**
 	 * > Increase the conflicts between player P1 and P2
 	 * > P1 is the new player being inserted in <G1, W1>  where P2 resides.   
-	 * > ALWAYS inserts <w1, g1, p1> in conflict_set 
+	 * > ALWAYS inserts <w1, p1> in conflict_set 
 	 * if the conflicts become > 1
 	 * > inserts ALL other positions of P1 and P2 in conflict_set if 
 	 * conflicts becomes 2 by inserting P1.
@@ -131,7 +340,7 @@ class SGP{
 	/**
 	 * Decrease the conflicts between player P1 and P2
 	 * P1 is the player being erased from < W1, G1> where P2 resides  
-	 * ALWAYS removes < w1, g1, p1> from conflict_set.
+	 * ALWAYS removes < w1, p1> from conflict_set.
 	 * Removes ALL other positions of P1 and P2 in conflict_set if 
 	 * conflicts become 1 by removing P1.
 	 */
@@ -139,11 +348,28 @@ class SGP{
 	dec_conflict(unsigned int w1, unsigned int g1, 	unsigned int p1, 
 													unsigned int p2);
 
+	/**
+	 * PRE-CONDITION: <W, VAL> is not pinned. set_field only changes free
+	 * groups, so only the other weeks reached by inc_conflict need a 
+	 * test, against _first_group.
+	 */
 	void 
 	add_conflict(unsigned int w, unsigned int g, unsigned int val);
 	
+	/**
+	 * Removes <W, VAL> from conflict_set unless VAL has already been 
+	 * moved to a group other than G in week W (second half of a swap).
+	 */
 	void 
 	remove_conflict(unsigned int w, unsigned int g, unsigned int val);
+
+	/**
+	 * Re-evaluates whether <W, PLAYER> belongs in conflict_set, 
+	 * based on the group PLAYER is currently recorded in.
+	 * PRE-CONDITION: <W, PLAYER> is not pinned
+	 */
+	void 
+	refresh_conflict(unsigned int w, unsigned int player);
 	
 	/**
 	 * set the <(W, G, _)> = OLD_VAL cell to NEW_VAL and adjusts the 
@@ -166,6 +392,70 @@ class SGP{
 	calc_conflicts_diff_in_group(	unsigned int w,	unsigned int g, 
 									int old_val, 	int new_val);
 	
+	/**
+	 * Calculates the nett conflicts difference of swapping A in <W, GA> 
+	 * with B in <W, GB> from the gain tables. 
+	 * Equals calc_conflicts_diff_in_group(W, GA, A, B) + 
+	 * 			calc_conflicts_diff_in_group(W, GB, B, A)
+	 */
+	inline int 
+	calc_swap_diff(	unsigned int w, unsigned int a, unsigned int ga,
+									unsigned int b, unsigned int gb) const{
+		const unsigned int n = _g * _p;
+		const unsigned short *met = &_met_in_group[w * _g * n];
+		const unsigned short *twice = &_twice_in_group[w * _g * n];
+		return 	met[ga * n + b] - twice[ga * n + a] + 
+				met[gb * n + a] - twice[gb * n + b] -
+				2 * static_cast<int>(bits::test(met_once(a), b));
+	}
+
+	/**
+	 * Records PLAYER as a member of <W, G> in _groups, the group mask 
+	 * and the gain tables (resp. removes it from all three).
+	 */
+	void 
+	join_group(unsigned int w, unsigned int g, unsigned int player);
+
+	void 
+	leave_group(unsigned int w, unsigned int g, unsigned int player);
+
+	/**
+	 * Adds (SIGN = 1) or removes (SIGN = -1) the contribution of PLAYER 
+	 * as a member of <W, G> to the gain tables.
+	 */
+	void 
+	gain_member(unsigned int w, unsigned int g, unsigned int player, 
+																int sign);
+
+	/**
+	 * Updates the gain tables after the meeting count of P1 and P2 
+	 * has changed to COUNT by DELTA (+1 / -1).
+	 */
+	void 
+	gain_pair(	unsigned int p1, unsigned int p2, unsigned int count, 
+																int delta);
+
+	/**
+	 * Returns true if PLAYER has met some member of <W, G> at least twice
+	 */
+	inline bool 
+	has_conflict_in_group(	unsigned int w, unsigned int g,
+							unsigned int player) const{
+		return bits::intersects(met_twice(player), group_mask(w, g), 
+															_mask_words);
+	}
+
+	/**
+	 * Scores every swap of the conflict cells [BEGIN, END) of conflict_set
+	 * with a member of another group of the same week into BATCH.
+	 * BATCH.cell holds the index of the conflict cell. The swaps of a 
+	 * cell are scored in bulk by kernel::score_swaps and their tabu 
+	 * flags filled by SGPTabuList::tabu_mask.
+	 */
+	void 
+	collect_moves(	SGPTabuList& tabu, unsigned int begin, unsigned int end,
+					MoveBatch& batch);
+
 	/**
 	 * Returns the accumulated conflicts of PLAYER only in this group <W,G> 
 	 */
@@ -177,6 +467,50 @@ class SGP{
 	unsigned int 
 	calc_conflicts_player(int player);
 
+	inline int* group_begin(unsigned int w, unsigned int g){
+		return &_tables[(w * _g + g) * _p];
+	}
+
+	inline int* group_end(unsigned int w, unsigned int g){
+		return group_begin(w, g) + _tables_size[w * _g + g];
+	}
+
+	inline const int* group_begin(unsigned int w, unsigned int g) const{
+		return &_tables[(w * _g + g) * _p];
+	}
+
+	inline const int* group_end(unsigned int w, unsigned int g) const{
+		return group_begin(w, g) + _tables_size[w * _g + g];
+	}
+
+	inline bool frozen(unsigned int w, unsigned int player) const{
+		return bits::test(&_frozen[w * _mask_words], player);
+	}
+
+	inline bits::word* group_mask(unsigned int w, unsigned int g){
+		return &_group_mask[(w * _g + g) * _mask_words];
+	}
+
+	inline const bits::word* group_mask(unsigned int w, unsigned int g) const{
+		return &_group_mask[(w * _g + g) * _mask_words];
+	}
+
+	inline bits::word* met_once(unsigned int player){
+		return &_met_once[player * _mask_words];
+	}
+
+	inline const bits::word* met_once(unsigned int player) const{
+		return &_met_once[player * _mask_words];
+	}
+
+	inline bits::word* met_twice(unsigned int player){
+		return &_met_twice[player * _mask_words];
+	}
+
+	inline const bits::word* met_twice(unsigned int player) const{
+		return &_met_twice[player * _mask_words];
+	}
+
 	inline 
 	log4cpp::Category& logger() {
 		static log4cpp::Category& logger(
@@ -186,6 +520,11 @@ class SGP{
 };
 
 
+typedef BasicSGP<DynamicDims> SGP;
+
+template<unsigned int G, unsigned int P, unsigned int W>
+using FixedSGP = BasicSGP<FixedDims<G, P, W>>;
+
 /**
  * Base type for all solvers
  */
@@ -193,8 +532,19 @@ class SGPSolver{
 	public:
 		virtual ~SGPSolver() {};
 		virtual void run() = 0;
+		/**
+		 * CPU time of the process during the last run(), in seconds; 
+		 * includes every thread, so it exceeds wall_time() when the 
+		 * search runs on several.
+		 */
 		virtual double runtime() = 0;
+		/* Wall-clock time of the last run(), in seconds */
+		virtual double wall_time() = 0;
 		virtual unsigned int iterations() = 0;
+		/* Searches the last run() started over from a new solution */
+		virtual unsigned int restarts() = 0;
+		/* Makes the next run() reproducible */
+		virtual void seed(std::uint64_t seed) = 0;
 };
 
 } // NAMESPACE_SGP
@@ -0,0 +1,42 @@
+#include "stats.hh"
+
+/**-------------------------------**/
+void sgp::SearchStats::clear()
+{
+	*this = SearchStats();
+}
+
+/**-------------------------------**/
+void sgp::SearchStats::milestone(	unsigned int iteration, int eval, 
+									double seconds)
+{
+	milestones.push_back(Milestone{iteration, eval, seconds});
+	iterations_to_best = iteration;
+	best_eval = eval;
+}
+
+/**-------------------------------**/
+void sgp::SearchStats::print_json(std::ostream& os) const
+{
+	os 	<< "{\"iterations\": " << iterations
+		<< ", \"best_eval\": " << best_eval
+		<< ", \"iterations_to_best\": " << iterations_to_best
+		<< ", \"moves_evaluated\": " << moves_evaluated
+		<< ", \"tabu_rejections\": " << tabu_rejections
+		<< ", \"aspirations\": " << aspirations
+		<< ", \"restarts\": " << restarts
+		<< ", \"near_misses\": [" << near_misses[0] << ", " 
+			<< near_misses[1] << ", " << near_misses[2] << "]"
+		<< ", \"peak_conflicts\": " << peak_conflicts
+		<< ", \"restart_seconds\": " << restart_seconds
+		<< ", \"search_seconds\": " << search_seconds
+		<< ", \"timed_out\": " << (timed_out ? "true" : "false")
+		<< ", \"milestones\": [";
+	for(std::size_t i = 0 ; i < milestones.size() ; i++){
+		os 	<< (i == 0 ? "" : ", ") 
+			<< "{\"iteration\": " << milestones[i].iteration
+			<< ", \"eval\": " << milestones[i].eval
+			<< ", \"seconds\": " << milestones[i].seconds << "}";
+	}
+	os << "]}";
+}
@@ -0,0 +1,58 @@
+#ifndef _STATS_HH
+#define _STATS_HH
+
+#include <vector>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+namespace sgp{
+
+/**
+ * Counters of the last run() of a solver. The solver fills in the 
+ * per-run figures; local_search adds the per-move ones when the 
+ * instance has been given the object (BasicSGP::set_stats).
+ * Every update is an increment or a compare, cheap enough to stay on.
+ */
+struct SearchStats{
+
+	/* A new best eval, reached in ITERATION after SECONDS of run() */
+	struct Milestone{
+		unsigned int iteration;
+		int eval;
+		double seconds;
+	};
+
+	/* swap moves scored by local_search */
+	std::uint64_t moves_evaluated = 0;
+	/* steps where a better move was given up because it was tabu */
+	std::uint64_t tabu_rejections = 0;
+	/* steps taking a tabu move because it beat the best eval */
+	std::uint64_t aspirations = 0;
+	unsigned int restarts = 0;
+	unsigned int iterations = 0;
+	unsigned int iterations_to_best = 0;
+	int best_eval = 0;
+	/* largest conflict set a move was chosen from */
+	std::size_t peak_conflicts = 0;
+	/* building the first and every restart solution */
+	double restart_seconds = 0;
+	/* everything else, the local search steps mostly */
+	double search_seconds = 0;
+	/* the run was stopped by its time limit */
+	bool timed_out = false;
+	/* search cycles (up to a restart) whose best eval was 1, 2 and 3 */
+	unsigned int near_misses[3] = {0, 0, 0};
+	std::vector<Milestone> milestones;
+
+	/* Back to the state before the first run */
+	void clear();
+	/* Records a new best EVAL */
+	void milestone(unsigned int iteration, int eval, double seconds);
+	/* Writes the counters as one JSON object on a single line */
+	void print_json(std::ostream& os) const;
+};
+
+} // NAMESPACE_SGP
+
+#endif //_STATS_HH
@@ -1,11 +1,32 @@
 #include "tabu.hh"
+#include "engine.hh"
+#include "elite.hh"
+#include "binary.hh"
 #include <stdexcept>
 #include <functional>
 #include <ctime>
+#include <climits>
+#include <algorithm>
 #include <log4cpp/Category.hh>
 
 static log4cpp::Category& logger( log4cpp::Category::getInstance("tabu")); 
 
+/* first word of a saved tabu list */
+static const std::uint32_t DOTU_TAG = 0x55544f44;	/* "DOTU" */
+static const std::uint32_t FLAT_TAG = 0x54414c46;	/* "FLAT" */
+
+/* Reads the saved tenure bounds, which must be LB and UB */
+static void check_tenures(std::istream& is, unsigned int lb, unsigned int ub)
+{
+	unsigned int saved_lb, saved_ub;
+	sgp::binary::read(is, saved_lb);
+	sgp::binary::read(is, saved_ub);
+	if(saved_lb != lb || saved_ub != ub){
+		throw std::invalid_argument("tabu list with tenures " + 
+				std::to_string(saved_lb) + ".." + std::to_string(saved_ub));
+	}
+}
+
 /**=====   SGPDotuTabuList ========**/
 /**================================**/
 
@@ -27,18 +48,14 @@ sgp::SGPDotuTabuList::TabuElemHasher::operator()(const TabuElem& e) const
 /**=====  END ::TabuElemHash ==**/
 
 /**-------------------------------**/
-sgp::SGPDotuTabuList::SGPDotuTabuList(const SGP& sgp) 
-	: 	SGPDotuTabuList(sgp, 4, 100)
-{}
-
-/**-------------------------------**/
-sgp::SGPDotuTabuList::SGPDotuTabuList(	const SGP& sgp, 
+sgp::SGPDotuTabuList::SGPDotuTabuList(	unsigned int g, unsigned int p,
+										unsigned int w,
 										unsigned int lower_tabu,
 										unsigned int upper_tabu) 
-	: 	tlist(	sgp.w(),
+	: 	tlist(	w,
 				std::unordered_set<TabuElem, TabuElemHasher>(
 										10,
-										TabuElemHasher( sgp.g() * sgp.p() )
+										TabuElemHasher( g * p )
 										)
 			),
 		iteration(0),
@@ -58,7 +75,7 @@ void sgp::SGPDotuTabuList::add(unsigned int week, int player1, int player2)
 	}
 	
 	/* t in [lb, ub]*/
-	unsigned int iter_val = sgp::gen_rand(iter_ub - iter_lb) + iter_lb; 
+	unsigned int iter_val = rng(iter_ub - iter_lb) + iter_lb; 
 	iter_val += iteration;
 	auto result = 
 		tlist[week].insert(
@@ -83,6 +100,21 @@ bool sgp::SGPDotuTabuList::is_tabu(unsigned int week, int player1, int player2)
 			iteration < iter->i ;
 }
 
+/**-------------------------------**/
+void sgp::SGPDotuTabuList::tabu_mask(	unsigned int week, int player, 
+										const int* others, unsigned int count,
+										int* mask)
+{
+	if(week >= tlist.size() ){
+		throw std::domain_error("Invalid week in tabu list");
+	}
+	const auto &tabu = tlist[week];
+	for(unsigned int k = 0 ; k < count ; k++){
+		auto iter = tabu.find(TabuElem{player, others[k], 0});
+		mask[k] = -static_cast<int>(iter != tabu.end() && iteration < iter->i);
+	}
+}
+
 /**-------------------------------**/
 void sgp::SGPDotuTabuList::clear(unsigned int week)
 {
@@ -111,110 +143,561 @@ void sgp::SGPDotuTabuList::incr_iteration()
 	iteration++;
 }
 
+/**-------------------------------**/
+void sgp::SGPDotuTabuList::seed(std::uint64_t seed)
+{
+	rng.seed(seed);
+}
+
+/**-------------------------------**/
+void sgp::SGPDotuTabuList::save(std::ostream& os) const
+{
+	binary::write(os, DOTU_TAG);
+	binary::write(os, static_cast<std::uint32_t>(tlist.size()));
+	binary::write(os, iter_lb);
+	binary::write(os, iter_ub);
+	binary::write(os, iteration);
+	std::uint64_t state[4];
+	rng.save(state);
+	binary::write(os, state);
+	/* expired moves are left out, they are no longer tabu */
+	std::vector<std::int32_t> active;
+	for(const auto &week : tlist){
+		active.clear();
+		for(const TabuElem &e : week){
+			if(iteration < e.i){
+				active.push_back(e.a);
+				active.push_back(e.b);
+				active.push_back(static_cast<std::int32_t>(e.i));
+			}
+		}
+		binary::write_vector(os, active);
+	}
+}
+
+/**-------------------------------**/
+void sgp::SGPDotuTabuList::load(std::istream& is)
+{
+	std::uint32_t tag, weeks;
+	binary::read(is, tag);
+	binary::read(is, weeks);
+	if(tag != DOTU_TAG || weeks != tlist.size())
+		throw std::invalid_argument("tabu list of another kind or instance");
+	check_tenures(is, iter_lb, iter_ub);
+	binary::read(is, iteration);
+	std::uint64_t state[4];
+	binary::read(is, state);
+	rng.restore(state);
+
+	const int n = tlist[0].hash_function().week_size;
+	std::vector<std::int32_t> active;
+	for(auto &week : tlist){
+		week.clear();
+		binary::read_vector(is, active, 3 * n * n);
+		if(active.size() % 3 != 0)
+			throw std::invalid_argument("corrupt checkpoint");
+		for(std::size_t k = 0 ; k < active.size() ; k += 3){
+			if(	active[k] < 0 || active[k] >= n || 
+				active[k + 1] < 0 || active[k + 1] >= n)
+				throw std::invalid_argument("corrupt checkpoint");
+			week.insert(TabuElem{	active[k], active[k + 1], 
+									static_cast<unsigned int>(active[k + 2])});
+		}
+	}
+}
+
+/**=====   SGPFlatTabuList ========**/
+/**================================**/
+sgp::SGPFlatTabuList::SGPFlatTabuList(	unsigned int g, unsigned int p,
+										unsigned int w,
+										unsigned int lower_tabu,
+										unsigned int upper_tabu) 
+	: 	n(g * p),
+		weeks(w),
+		week_size(static_cast<size_t>(n) * (n - 1) / 2),
+		expiry(weeks * week_size, 0),
+		iteration(0),
+		iter_lb(lower_tabu),
+		iter_ub(upper_tabu)
+{
+	if(lower_tabu > upper_tabu)
+		throw std::invalid_argument("Lower tabu < upper tabu");
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::check(	unsigned int week, 
+									int player1, int player2) const
+{
+	if(week >= weeks){
+		throw std::domain_error("Invalid week in tabu list");
+	}
+	if(	player1 < 0 || player2 < 0 || 
+		static_cast<unsigned int>(player1) >= n || 
+		static_cast<unsigned int>(player2) >= n){
+		throw std::domain_error("Invalid player in tabu list");
+	}
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::add(unsigned int week, int player1, int player2) 
+{
+	check(week, player1, player2);
+	if(player1 == player2)
+		return;
+	
+	/* t in [lb, ub]*/
+	unsigned int iter_val = rng(iter_ub - iter_lb) + iter_lb; 
+	expiry[index(week, player1, player2)] = iteration + iter_val;
+}
+
+/**-------------------------------**/
+bool sgp::SGPFlatTabuList::is_tabu(unsigned int week, int player1, int player2)
+{
+	if(week >= weeks){
+		throw std::domain_error("Invalid week in tabu list");
+	}
+	return 	player1 != player2 &&
+			iteration < expiry[index(week, player1, player2)];
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::tabu_mask(	unsigned int week, int player, 
+										const int* others, unsigned int count,
+										int* mask)
+{
+	if(week >= weeks){
+		throw std::domain_error("Invalid week in tabu list");
+	}
+	for(unsigned int k = 0 ; k < count ; k++){
+		mask[k] = 	-static_cast<int>(player != others[k] &&
+					iteration < expiry[index(week, player, others[k])]);
+	}
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::clear(unsigned int week)
+{
+	if(week >= weeks){
+		throw std::domain_error("Invalid week in tabu list");
+	}
+	std::fill(	expiry.begin() + week * week_size, 
+				expiry.begin() + (week + 1) * week_size, 0);
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::clearAll()
+{
+	/* every stored expiry is below iteration + iter_ub */
+	if(iteration > UINT_MAX - 2 * iter_ub - 1){
+		std::fill(expiry.begin(), expiry.end(), 0);
+		iteration = 0;
+	}else{
+		iteration += iter_ub;
+	}
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::incr_iteration()
+{
+	if(iteration >= UINT_MAX - iter_ub - 1){
+		/* wrap around before the expiries overflow */
+		for(auto &e : expiry)
+			e = e > iteration ? e - iteration : 0;
+		iteration = 0;
+	}
+	iteration++;
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::seed(std::uint64_t seed)
+{
+	rng.seed(seed);
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::save(std::ostream& os) const
+{
+	binary::write(os, FLAT_TAG);
+	binary::write(os, static_cast<std::uint64_t>(expiry.size()));
+	binary::write(os, iter_lb);
+	binary::write(os, iter_ub);
+	binary::write(os, iteration);
+	std::uint64_t state[4];
+	rng.save(state);
+	binary::write(os, state);
+	/* only the pairs still tabu, as (index, expiry) */
+	std::vector<std::uint64_t> active;
+	for(size_t i = 0 ; i < expiry.size() ; i++){
+		if(iteration < expiry[i])
+			active.push_back(	(static_cast<std::uint64_t>(i) << 32) | 
+								expiry[i]);
+	}
+	binary::write_vector(os, active);
+}
+
+/**-------------------------------**/
+void sgp::SGPFlatTabuList::load(std::istream& is)
+{
+	std::uint32_t tag;
+	std::uint64_t size;
+	binary::read(is, tag);
+	binary::read(is, size);
+	if(tag != FLAT_TAG || size != expiry.size())
+		throw std::invalid_argument("tabu list of another kind or instance");
+	check_tenures(is, iter_lb, iter_ub);
+	binary::read(is, iteration);
+	std::uint64_t state[4];
+	binary::read(is, state);
+	rng.restore(state);
+
+	std::vector<std::uint64_t> active;
+	binary::read_vector(is, active, expiry.size());
+	std::fill(expiry.begin(), expiry.end(), 0);
+	for(std::uint64_t a : active){
+		if((a >> 32) >= expiry.size())
+			throw std::invalid_argument("corrupt checkpoint");
+		expiry[a >> 32] = static_cast<unsigned int>(a);
+	}
+}
+
+/**-------------------------------**/
+sgp::SGPFlatTabuList::~SGPFlatTabuList()
+{}
+
 /**================================**/
 /**=========  SGPTabuSolver =======**/
 /**================================**/
-sgp::SGPTabuSolver::SGPTabuSolver(SGP& sgp, int max_tries, int max_stable)
+template<class S>
+sgp::BasicSGPTabuSolver<S>::BasicSGPTabuSolver(	S& sgp, int max_tries, 
+												int max_stable)
 	: 	sgp(sgp),
 		runtime_(0),
+		wall_time_(0),
+		time_limit(0),
 		iterations_(0),
    		max_tries(max_tries),
-		max_stable(max_stable)	
+		max_stable(max_stable),
+		cancel(nullptr),
+		elite(nullptr),
+		perturbation(0),
+		checkpoint_every(0),
+		resuming(false)
 {}
 
 /**-------------------------------**/
-void sgp::SGPTabuSolver::run(void) 
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::run(void) 
 {
-	/* clear tabu list for all weeks */
-	tabu_list().clearAll();
-	
-	std::clock_t start = std::clock(); /* START TIME */
-	sgp.init_solution();
+	if(elite != nullptr && (checkpoint_every > 0 || resuming))
+		throw std::invalid_argument("checkpoints without an elite pool only");
 
+	std::clock_t start = std::clock(); /* START TIME */
+	deadline.start(time_limit);
 	int tries = 0;
 	int stable_tries = 0;
-	SGP best_sgp(sgp);
-	int iter_best = sgp.get_eval();
-	double cnt[] = {0.0 , 0.0, 0.0};
-	double total = 0.0;
+	SGPSnapshot best;
+	int iter_best;
+	if(resuming){
+		/* the instance and the tabu list were restored by resume() */
+		resuming = false;
+		stats_ = point.stats;
+		sgp.set_stats(&stats_);
+		tries = point.tries;
+		stable_tries = point.stable_tries;
+		iter_best = point.iter_best;
+		best = point.best;
+		SGP_INFO(logger, "Resuming after %d iterations (best eval %d)", 
+															tries, best.eval);
+	}else{
+		/* clear tabu list for all weeks */
+		tabu_list().clearAll();
+		stats_.clear();
+		sgp.set_stats(&stats_);
+		sgp.init_solution();
+		stats_.restart_seconds = deadline.elapsed();
+		stats_.milestone(0, sgp.get_eval(), stats_.restart_seconds);
+		sgp.save(best);
+		iter_best = sgp.get_eval();
+	}
+	const int first_try = tries;
+
+	/* best solution of the current cycle, kept only when cooperating */
+	SGPSnapshot cycle_best;
+	if(elite != nullptr)
+		sgp.save(cycle_best);
+	unsigned int near_misses = 	stats_.near_misses[0] + stats_.near_misses[1] +
+								stats_.near_misses[2];
 	while(tries < max_tries)
 	{
 		if(sgp.get_eval() == 0){
 			break;
 		}
+		if(cancel != nullptr && cancel->load(std::memory_order_relaxed)){
+			SGP_INFO(logger, "Cancelled after %d iterations", tries);
+			break;
+		}
+		if(deadline.expired()){
+			SGP_INFO(logger, "Time limit reached after %d iterations", tries);
+			stats_.timed_out = true;
+			break;
+		}
+		if(	checkpoint_every > 0 && tries != first_try && 
+			tries % checkpoint_every == 0)
+			checkpoint(tries, stable_tries, iter_best, best);
 		
-		sgp.local_search(tabu_list(), best_sgp.get_eval());
+		sgp.local_search(tabu_list(), best.eval);
 	
 
-		if(sgp.get_eval() < best_sgp.get_eval()){
-			best_sgp = sgp;
-			logger.info("New best sgp (%d) found", sgp.get_eval() );
+		if(sgp.get_eval() < best.eval){
+			sgp.save(best);
+			if(elite != nullptr)
+				sgp.save(cycle_best);
+			SGP_INFO(logger, "New best sgp (%d) found", sgp.get_eval() );
+			stats_.milestone(tries + 1, best.eval, deadline.elapsed());
 			stable_tries = 0;
 			iter_best = sgp.get_eval();
 		}else if(stable_tries > max_stable){
 			tabu_list().clearAll();
 			stable_tries = 0;
-			sgp.init_solution();
+			if(elite != nullptr)
+				elite->offer(cycle_best);
+			const double restart_start = deadline.elapsed();
+			restart();
+			stats_.restart_seconds += deadline.elapsed() - restart_start;
+			stats_.restarts++;
+			if(elite != nullptr)
+				sgp.save(cycle_best);
 			
 			if(iter_best <= 3){
-				cnt[iter_best - 1]++;
-				total++;
+				stats_.near_misses[iter_best - 1]++;
+				near_misses++;
 			}
 			//std::cout << sgp << std::endl;
-			logger.info("MAX STABLE REACHED: iterations: %d", tries);
-			logger.info("Best eval reached in iteration: %d", iter_best);
-			logger.info("#1: %.2f, #2: %.2f , #3: %.2f", 	cnt[0]/total , 
-													cnt[1]/total,
-													cnt[2]/total	);
-			logger.info("Best eval: %d",best_sgp.get_eval());
+			SGP_INFO(logger, "MAX STABLE REACHED: iterations: %d", tries);
+			SGP_INFO(logger, "Best eval reached in iteration: %d", iter_best);
+			SGP_INFO(logger, "#1: %.2f, #2: %.2f , #3: %.2f", 	
+					stats_.near_misses[0] / static_cast<double>(near_misses),
+					stats_.near_misses[1] / static_cast<double>(near_misses),
+					stats_.near_misses[2] / static_cast<double>(near_misses));
+			SGP_INFO(logger, "Best eval: %d", best.eval);
 			
 			iter_best = sgp.get_eval();
 		}else{
 			stable_tries++;
-			if(sgp.get_eval() < iter_best)
+			if(sgp.get_eval() < iter_best){
 				iter_best = sgp.get_eval();
+				if(elite != nullptr)
+					sgp.save(cycle_best);
+			}
 		}	
 
 		tries++;
 		tabu_list().incr_iteration();
 	}
+	if(checkpoint_every > 0)
+		checkpoint(tries, stable_tries, iter_best, best);
 
 	this->runtime_ = 	(std::clock() - start ) / 
 						static_cast<double>(CLOCKS_PER_SEC);
 	this->iterations_ = tries;
-	sgp = best_sgp;
+	stats_.iterations = tries;
+	this->wall_time_ = deadline.elapsed();
+	stats_.search_seconds = wall_time_ - stats_.restart_seconds;
+	sgp.set_stats(nullptr);
+	sgp.restore(best);
 }
 
 /**-------------------------------**/
-double sgp::SGPTabuSolver::runtime(){ return runtime_; }
+template<class S>
+double sgp::BasicSGPTabuSolver<S>::runtime(){ return runtime_; }
+/**-------------------------------**/
+template<class S>
+double sgp::BasicSGPTabuSolver<S>::wall_time(){ return wall_time_; }
+/**-------------------------------**/
+template<class S>
+unsigned int sgp::BasicSGPTabuSolver<S>::iterations(){ return iterations_; }
+/**-------------------------------**/
+template<class S>
+unsigned int sgp::BasicSGPTabuSolver<S>::restarts(){ return stats_.restarts; }
+/**-------------------------------**/
+template<class S>
+const sgp::SearchStats& sgp::BasicSGPTabuSolver<S>::stats() const
+{
+	return stats_;
+}
 /**-------------------------------**/
-unsigned int sgp::SGPTabuSolver::iterations(){ return iterations_; }
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::seed(std::uint64_t seed)
+{
+	sgp.seed(Random::derive(seed, 0));
+	tabu_list().seed(Random::derive(seed, 1));
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::set_cancel(const std::atomic<bool>* flag)
+{
+	cancel = flag;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::set_time_limit(double seconds)
+{
+	time_limit = seconds;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::set_elite_pool(ElitePool* pool, 
+												unsigned int perturbation)
+{
+	this->elite = pool;
+	this->perturbation = perturbation;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::set_checkpoint(const std::string& path, 
+												unsigned int every)
+{
+	checkpoint_path = path;
+	checkpoint_every = every;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::resume(const std::string& path)
+{
+	resuming = false;
+	point.g = sgp.g();
+	point.p = sgp.p();
+	point.w = sgp.w();
+	point.init_alg = sgp.init_alg();
+	point.symmetry = sgp.symmetry();
+	point.max_stable = max_stable;
+	read_checkpoint(path, point, tabu_list());
+	/* best eval <= best of the cycle <= current eval, as run() keeps them */
+	if(	point.best.eval > point.iter_best || 
+		point.iter_best > point.current.solution.eval){
+		throw std::invalid_argument(path + ": corrupt checkpoint, "
+									"best evals do not match the solution");
+	}
+	if(	point.stable_tries > max_stable + 1u || 
+		point.stable_tries > point.tries){
+		throw std::invalid_argument(path + ": corrupt checkpoint, "
+									"more stable tries than possible");
+	}
+	try{
+		/* the best solution is only restored when run() ends */
+		S scratch(sgp.g(), sgp.p(), sgp.w());
+		scratch.restore(point.best);
+		sgp.restore_state(point.current);
+	}catch(const std::invalid_argument &e){
+		throw std::invalid_argument(path + ": corrupt checkpoint, " + e.what());
+	}
+	resuming = true;
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::checkpoint(int tries, int stable_tries,
+											int iter_best,
+											const SGPSnapshot& best)
+{
+	point.g = sgp.g();
+	point.p = sgp.p();
+	point.w = sgp.w();
+	point.init_alg = sgp.init_alg();
+	point.symmetry = sgp.symmetry();
+	point.max_stable = max_stable;
+	point.tries = tries;
+	point.stable_tries = stable_tries;
+	point.iter_best = iter_best;
+	sgp.save_state(point.current);
+	point.best = best;
+	point.stats = stats_;
+	if(write_checkpoint(checkpoint_path, point, tabu_list()))
+		SGP_DEBUG(logger, "Checkpoint written after %d iterations", tries);
+	else
+		SGP_ERROR(logger, "Cannot write checkpoint %s", checkpoint_path.c_str());
+}
+/**-------------------------------**/
+template<class S>
+void sgp::BasicSGPTabuSolver<S>::restart()
+{
+	if(elite != nullptr && elite->sample(sgp.rng(), restart_from)){
+		sgp.restore(restart_from);
+		sgp.perturb(perturbation);
+		SGP_INFO(logger, "Restarting from an elite solution (%d)", 
+															restart_from.eval);
+	}else{
+		sgp.init_solution();
+	}
+}
 /**-------------------------------**/
 
 
 /**================================**/
 /**=====  SGPDotuTabuSolver =======**/
 /**================================**/
-sgp::SGPDotuTabuSolver::SGPDotuTabuSolver( 	SGP& sgp, 
-											unsigned int max_tries, 
-											unsigned int max_stable)
-	: 	SGPTabuSolver(sgp, max_tries, max_stable),
+template<class S>
+sgp::BasicSGPDotuTabuSolver<S>::BasicSGPDotuTabuSolver( 	S& sgp, 
+													unsigned int max_tries, 
+													unsigned int max_stable)
+	: 	BasicSGPTabuSolver<S>(sgp, max_tries, max_stable),
+		tlist(sgp, 4, 100)	
+{}
+
+template<class S>
+sgp::BasicSGPDotuTabuSolver<S>::BasicSGPDotuTabuSolver( 	S& sgp, 
+													unsigned int max_tries, 
+													unsigned int max_stable,
+													unsigned int tabu_min, 
+													unsigned int tabu_max)
+	: 	BasicSGPTabuSolver<S>(sgp, max_tries, max_stable),
+		tlist(sgp, tabu_min, tabu_max)	
+{}
+
+
+/**-------------------------------**/
+template<class S>
+sgp::SGPTabuList& sgp::BasicSGPDotuTabuSolver<S>::tabu_list(){
+	return tlist;
+}
+/**-------------------------------**/
+
+
+/**================================**/
+/**=====  SGPFlatTabuSolver =======**/
+/**================================**/
+template<class S>
+sgp::BasicSGPFlatTabuSolver<S>::BasicSGPFlatTabuSolver( 	S& sgp, 
+													unsigned int max_tries, 
+													unsigned int max_stable)
+	: 	BasicSGPTabuSolver<S>(sgp, max_tries, max_stable),
 		tlist(sgp, 4, 100)	
 {}
 
-sgp::SGPDotuTabuSolver::SGPDotuTabuSolver( 	SGP& sgp, 
-											unsigned int max_tries, 
-											unsigned int max_stable,
-											unsigned int tabu_min, 
-											unsigned int tabu_max)
-	: 	SGPTabuSolver(sgp, max_tries, max_stable),
+template<class S>
+sgp::BasicSGPFlatTabuSolver<S>::BasicSGPFlatTabuSolver( 	S& sgp, 
+													unsigned int max_tries, 
+													unsigned int max_stable,
+													unsigned int tabu_min, 
+													unsigned int tabu_max)
+	: 	BasicSGPTabuSolver<S>(sgp, max_tries, max_stable),
 		tlist(sgp, tabu_min, tabu_max)	
 {}
 
 
 /**-------------------------------**/
-sgp::SGPTabuList& sgp::SGPDotuTabuSolver::tabu_list(){
+template<class S>
+sgp::SGPTabuList& sgp::BasicSGPFlatTabuSolver<S>::tabu_list(){
 	return tlist;
 }
 /**-------------------------------**/
 
+/**-------------------------------**/
+#define SGP_INSTANTIATE(G, P, W) 										\
+	template class sgp::BasicSGPTabuSolver<sgp::FixedSGP<G, P, W>>;		\
+	template class sgp::BasicSGPDotuTabuSolver<sgp::FixedSGP<G, P, W>>;	\
+	template class sgp::BasicSGPFlatTabuSolver<sgp::FixedSGP<G, P, W>>;
+
+template class sgp::BasicSGPTabuSolver<sgp::SGP>;
+template class sgp::BasicSGPDotuTabuSolver<sgp::SGP>;
+template class sgp::BasicSGPFlatTabuSolver<sgp::SGP>;
+SGP_FIXED_INSTANCES(SGP_INSTANTIATE)
@@ -2,20 +2,45 @@
 #define _TABU_HH
 
 #include <unordered_set>
+#include <atomic>
+#include <istream>
+#include <ostream>
+#include <string>
 #include "sgp.hh"
+#include "stats.hh"
+#include "deadline.hh"
+#include "checkpoint.hh"
 
 namespace sgp{
 
 /**
  * Interface for Tabu Lists used in local search for SGP
  */
+class ElitePool;
+
 class SGPTabuList{
   	public:
 	virtual void add(unsigned int week, int player1, int player2) = 0;
 	virtual bool is_tabu(unsigned int week, int player1, int player2) = 0;
+	/**
+	 * MASK[K] = -1 if swapping PLAYER with OTHERS[K] in WEEK is tabu and
+	 * 0 otherwise, for K < COUNT (the MoveBatch::tabu convention)
+	 */
+	virtual void tabu_mask(	unsigned int week, int player, const int* others,
+							unsigned int count, int* mask) = 0;
 	virtual void clear(unsigned int week) = 0;
 	virtual void clearAll() = 0;
 	virtual void incr_iteration() = 0;
+	/* Restarts the generator of the tabu tenures from SEED */
+	virtual void seed(std::uint64_t seed) = 0;
+	/**
+	 * Writes the tabu moves still in force, the iteration and the 
+	 * generator in binary to OS (see binary.hh); load() continues 
+	 * from them. load() throws std::invalid_argument for the state of
+	 * another kind of list, instance or tenure bounds.
+	 */
+	virtual void save(std::ostream& os) const = 0;
+	virtual void load(std::istream& is) = 0;
 	virtual ~SGPTabuList() {};
 };
 
@@ -50,59 +75,218 @@ class SGPDotuTabuList : public SGPTabuList
 	};
 
 	std::vector<std::unordered_set<TabuElem, TabuElemHasher>> tlist;
+	Random rng;
 	unsigned int iteration;
    	unsigned int iter_lb; /* iteration tabu lower bound */ 	
    	unsigned int iter_ub; /* iteration tabu upper bound */ 	
  
   public:
-	SGPDotuTabuList(const SGP& sgp);
-	SGPDotuTabuList(const SGP& sgp, unsigned int lower_tabu, 
-									unsigned int upper_tabu);
+	template<class S>
+	explicit SGPDotuTabuList(const S& sgp)
+		: SGPDotuTabuList(sgp.g(), sgp.p(), sgp.w(), 4, 100)
+	{}
+	template<class S>
+	SGPDotuTabuList(const S& sgp, 	unsigned int lower_tabu, 
+									unsigned int upper_tabu)
+		: SGPDotuTabuList(sgp.g(), sgp.p(), sgp.w(), lower_tabu, upper_tabu)
+	{}
+	SGPDotuTabuList(unsigned int g, unsigned int p, unsigned int w, 
+					unsigned int lower_tabu, unsigned int upper_tabu);
 	void add(unsigned int week, int player1, int player2);
 	bool is_tabu(unsigned int week, int player1, int player2);
+	void tabu_mask(	unsigned int week, int player, const int* others,
+					unsigned int count, int* mask);
 	void clear(unsigned int week);
 	void clearAll();
 	void incr_iteration();
+	void seed(std::uint64_t seed);
+	void save(std::ostream& os) const;
+	void load(std::istream& is);
 	~SGPDotuTabuList();
 }; 
 
 /**
- * Base class for all tabu algorithms
+ * Tabu list backed by a dense array of expiry iterations
+ * Holds one counter per unordered pair of players and week 
+ * (W * N * (N - 1) / 2 in total), so is_tabu is one load and one compare.
+ * clearAll advances the iteration past every stored expiry in O(1).
+ */
+class SGPFlatTabuList : public SGPTabuList 
+{
+	
+  private:
+	unsigned int n;			/* #players */
+	unsigned int weeks;
+	size_t week_size;		/* #pairs per week */
+	/* First iteration where a pair can be swapped again */
+	std::vector<unsigned int> expiry;
+	Random rng;
+	unsigned int iteration;
+   	unsigned int iter_lb; /* iteration tabu lower bound */ 	
+   	unsigned int iter_ub; /* iteration tabu upper bound */ 	
+
+	inline size_t index(unsigned int week, int player1, int player2) const{
+		const size_t a = player1 < player2 ? player1 : player2;
+		const size_t b = player1 < player2 ? player2 : player1;
+		return week * week_size + b * (b - 1) / 2 + a;
+	}
+
+	void check(unsigned int week, int player1, int player2) const;
+ 
+  public:
+	template<class S>
+	explicit SGPFlatTabuList(const S& sgp)
+		: SGPFlatTabuList(sgp.g(), sgp.p(), sgp.w(), 4, 100)
+	{}
+	template<class S>
+	SGPFlatTabuList(const S& sgp, 	unsigned int lower_tabu, 
+									unsigned int upper_tabu)
+		: SGPFlatTabuList(sgp.g(), sgp.p(), sgp.w(), lower_tabu, upper_tabu)
+	{}
+	SGPFlatTabuList(unsigned int g, unsigned int p, unsigned int w, 
+					unsigned int lower_tabu, unsigned int upper_tabu);
+	void add(unsigned int week, int player1, int player2);
+	bool is_tabu(unsigned int week, int player1, int player2);
+	void tabu_mask(	unsigned int week, int player, const int* others,
+					unsigned int count, int* mask);
+	void clear(unsigned int week);
+	void clearAll();
+	void incr_iteration();
+	void seed(std::uint64_t seed);
+	void save(std::ostream& os) const;
+	void load(std::istream& is);
+	~SGPFlatTabuList();
+}; 
+
+/**
+ * Base class for all tabu algorithms, running on instances of type S
+ * (SGP or a FixedSGP<G, P, W>)
  */
-class SGPTabuSolver : public SGPSolver
+template<class S>
+class BasicSGPTabuSolver : public SGPSolver
 {
 	protected:
-		SGP& sgp;
+		S& sgp;
 		double runtime_;
+		double wall_time_;
+		double time_limit;
+		Deadline deadline;
 		unsigned int iterations_;
+		SearchStats stats_;
 		int max_tries;
 		int max_stable;
+		const std::atomic<bool>* cancel;
+		ElitePool* elite;
+		unsigned int perturbation;
+		SGPSnapshot restart_from;	/* scratch buffer of restart() */
+		std::string checkpoint_path;
+		unsigned int checkpoint_every;
+		bool resuming;
+		TabuCheckpoint point;	/* read by resume(), scratch of checkpoint() */
 		virtual SGPTabuList& tabu_list() = 0;
-		SGPTabuSolver(SGP& sgp, int max_tries, int max_stable);
-		virtual ~SGPTabuSolver() {};
+		/* Starts the next search cycle, see set_elite_pool */
+		void restart();
+		/* Writes the state at the top of the loop of run() */
+		void checkpoint(int tries, int stable_tries, int iter_best,
+						const SGPSnapshot& best);
+		BasicSGPTabuSolver(S& sgp, int max_tries, int max_stable);
+		virtual ~BasicSGPTabuSolver() {};
 	public:
 		void run(void);
 		double runtime();
+		double wall_time();
 		unsigned int iterations();
+		/* Cycles ended by max_stable tries without improvement */
+		unsigned int restarts();
+		/* Counters of the last run() */
+		const SearchStats& stats() const;
+		/* Seeds the instance and the tabu list with derived streams */
+		void seed(std::uint64_t seed);
+		/**
+		 * run() stops at the next iteration once *FLAG becomes true;
+		 * nullptr (the default) disables cancellation.
+		 */
+		void set_cancel(const std::atomic<bool>* flag);
+		/**
+		 * run() stops once SECONDS of wall-clock time have passed 
+		 * (checked every Deadline::CHECK_INTERVAL iterations) and keeps 
+		 * the best solution found so far. 0 (the default): no limit.
+		 */
+		void set_time_limit(double seconds);
+		/**
+		 * Makes the solver cooperate through POOL: the best solution of
+		 * every search cycle is offered to it and, once it is not empty,
+		 * a cycle restarts from one of its members perturbed by 
+		 * PERTURBATION random swaps instead of from a random solution.
+		 * nullptr (the default) restores independent restarts.
+		 */
+		void set_elite_pool(ElitePool* pool, unsigned int perturbation);
+		/**
+		 * run() writes a checkpoint (see checkpoint.hh) to PATH every 
+		 * EVERY iterations and once more when it stops, so that 
+		 * resume() can continue the search. A checkpoint that cannot be
+		 * written is logged and the search goes on. EVERY = 0 (the 
+		 * default) disables checkpoints. Cannot be combined with an
+		 * elite pool.
+		 */
+		void set_checkpoint(const std::string& path, unsigned int every);
+		/**
+		 * Restores the instance and the tabu list from the checkpoint at
+		 * PATH; the next run() continues that search exactly as it would
+		 * have gone on, up to max_tries iterations in all. Call it after
+		 * seed(), which replaces the restored generators. Time limits 
+		 * and the times of stats() count from the resumed run() only.
+		 * Throws std::invalid_argument for a file that is not a 
+		 * checkpoint of this instance, tabu list (kind and tenures), 
+		 * initial construction, symmetry breaking and max_stable, and
+		 * for one whose current or best solution is not a schedule of
+		 * its eval or whose counters contradict them.
+		 */
+		void resume(const std::string& path);
 
 };
 
-class SGPDotuTabuSolver : public SGPTabuSolver
+template<class S>
+class BasicSGPDotuTabuSolver : public BasicSGPTabuSolver<S>
 {
   private:
 	SGPDotuTabuList tlist;
   protected:
 	SGPTabuList& tabu_list();
   public:
-	SGPDotuTabuSolver(SGP& sgp, unsigned int max_tries, 
-								unsigned int stable_tries);
-	SGPDotuTabuSolver(SGP& sgp, unsigned int max_tries, 	
-								unsigned int stable_tries,
-								unsigned int tabu_min, 	
-								unsigned int tabu_max);
-	~SGPDotuTabuSolver() {};
+	BasicSGPDotuTabuSolver(S& sgp, 	unsigned int max_tries, 
+									unsigned int stable_tries);
+	BasicSGPDotuTabuSolver(S& sgp, 	unsigned int max_tries, 	
+									unsigned int stable_tries,
+									unsigned int tabu_min, 	
+									unsigned int tabu_max);
+	~BasicSGPDotuTabuSolver() {};
 };
 
+/**
+ * Dotu tabu search running on the flat expiry-array tabu list
+ */
+template<class S>
+class BasicSGPFlatTabuSolver : public BasicSGPTabuSolver<S>
+{
+  private:
+	SGPFlatTabuList tlist;
+  protected:
+	SGPTabuList& tabu_list();
+  public:
+	BasicSGPFlatTabuSolver(S& sgp, 	unsigned int max_tries, 
+									unsigned int stable_tries);
+	BasicSGPFlatTabuSolver(S& sgp, 	unsigned int max_tries, 	
+									unsigned int stable_tries,
+									unsigned int tabu_min, 	
+									unsigned int tabu_max);
+	~BasicSGPFlatTabuSolver() {};
+};
+
+typedef BasicSGPTabuSolver<SGP> SGPTabuSolver;
+typedef BasicSGPDotuTabuSolver<SGP> SGPDotuTabuSolver;
+typedef BasicSGPFlatTabuSolver<SGP> SGPFlatTabuSolver;
+
 } // NAMESPACE_SGP
 
 #endif
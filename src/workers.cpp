@@ -0,0 +1,155 @@
+#include "workers.hh"
+#include <stdexcept>
+
+/**------------------------------------------------------------------------**/
+sgp::WorkerPool::WorkerPool(unsigned int threads)
+	: 	_job(nullptr),
+		_tasks(0),
+		_next(0),
+		_pending(0),
+		_generation(0),
+		_stop(false)
+{
+	if(threads == 0)
+		throw std::invalid_argument("worker pool without threads");
+	for(unsigned int i = 1 ; i < threads ; i++)
+		_threads.emplace_back(&WorkerPool::work, this);
+}
+
+/**------------------------------------------------------------------------**/
+sgp::WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wake.notify_all();
+	for(std::thread &t : _threads)
+		t.join();
+}
+
+/**------------------------------------------------------------------------**/
+unsigned int sgp::WorkerPool::threads() const
+{
+	return _threads.size() + 1;
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::WorkerPool::run(	unsigned int tasks, 
+							const std::function<void(unsigned int)>& job)
+{
+	if(tasks == 0)
+		return;
+	if(_threads.empty()){
+		for(unsigned int t = 0 ; t < tasks ; t++)
+			job(t);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_job = &job;
+		_tasks = tasks;
+		_next = 0;
+		_pending = _threads.size();
+		_generation++;
+	}
+	_wake.notify_all();
+	drain();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done.wait(lock, [this](){ return _pending == 0; });
+	_job = nullptr;
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::WorkerPool::drain()
+{
+	for(unsigned int t = _next++ ; t < _tasks ; t = _next++)
+		(*_job)(t);
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::WorkerPool::work()
+{
+	unsigned long seen = 0;
+	for(;;){
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [&](){ return _stop || _generation != seen; });
+			if(_stop)
+				return;
+			seen = _generation;
+		}
+		drain();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(--_pending == 0)
+				_done.notify_one();
+		}
+	}
+}
+
+/**------------------------------------------------------------------------**/
+sgp::StealingPool::StealingPool(unsigned int threads)
+	: 	_threads(threads),
+		_queues(threads)
+{
+	if(threads == 0)
+		throw std::invalid_argument("worker pool without threads");
+}
+
+/**------------------------------------------------------------------------**/
+unsigned int sgp::StealingPool::threads() const
+{
+	return _threads;
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::StealingPool::run(unsigned int tasks, 
+				const std::function<void(unsigned int, unsigned int)>& job)
+{
+	for(unsigned int t = 0 ; t < tasks ; t++)
+		_queues[t % _threads].tasks.push_back(t);
+
+	std::vector<std::thread> threads;
+	for(unsigned int k = 1 ; k < _threads && k < tasks ; k++)
+		threads.emplace_back(&StealingPool::work, this, k, std::cref(job));
+	work(0, job);
+	for(std::thread &t : threads)
+		t.join();
+}
+
+/**------------------------------------------------------------------------**/
+bool sgp::StealingPool::next(unsigned int k, unsigned int& task)
+{
+	{
+		Queue &own = _queues[k];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if(!own.tasks.empty()){
+			task = own.tasks.back();
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+	/* no task is ever added during a run, so one empty sweep is final */
+	for(unsigned int i = 1 ; i < _threads ; i++){
+		Queue &victim = _queues[(k + i) % _threads];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if(!victim.tasks.empty()){
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+/**------------------------------------------------------------------------**/
+void sgp::StealingPool::work(	unsigned int k, 
+				const std::function<void(unsigned int, unsigned int)>& job)
+{
+	unsigned int task;
+	while(next(k, task))
+		job(task, k);
+}
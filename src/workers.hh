@@ -0,0 +1,94 @@
+#ifndef _WORKERS_HH
+#define _WORKERS_HH
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <functional>
+
+namespace sgp{
+
+/**
+ * Persistent pool of threads running batches of small tasks.
+ * The threads are created once and sleep between batches, so a batch
+ * costs one wake-up instead of a thread creation per task.
+ * run() must not be called concurrently from several threads.
+ */
+class WorkerPool{
+
+  public:
+	/* THREADS counts the calling thread, which works on every batch too */
+	explicit WorkerPool(unsigned int threads);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	unsigned int threads() const;
+
+	/* Runs JOB(0) .. JOB(TASKS - 1) and returns once all have finished */
+	void run(unsigned int tasks, const std::function<void(unsigned int)>& job);
+
+  private:
+	std::vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	std::condition_variable _done;
+	const std::function<void(unsigned int)>* _job;
+	unsigned int _tasks;
+	std::atomic<unsigned int> _next;
+	unsigned int _pending;			/* threads still working on the batch */
+	unsigned long _generation;		/* number of batches started */
+	bool _stop;
+
+	void work();
+	void drain();
+};
+
+/**
+ * Work-stealing pool for long tasks of uneven length, such as whole 
+ * solver runs. Tasks are dealt round-robin to one deque per thread; a 
+ * thread takes its own tasks from the back and, once its deque is 
+ * empty, steals from the front of the others, so no thread idles while
+ * tasks are left. Threads live for one run() only: with tasks this 
+ * long, creating them is negligible.
+ */
+class StealingPool{
+
+  public:
+	/* THREADS counts the calling thread, which works on every run too */
+	explicit StealingPool(unsigned int threads);
+
+	StealingPool(const StealingPool&) = delete;
+	StealingPool& operator=(const StealingPool&) = delete;
+
+	unsigned int threads() const;
+
+	/**
+	 * Runs JOB(T, K) for T = 0 .. TASKS - 1, where K is the index of the
+	 * thread running it, and returns once all have finished.
+	 */
+	void run(	unsigned int tasks, 
+				const std::function<void(unsigned int, unsigned int)>& job);
+
+  private:
+	struct Queue{
+		std::mutex mutex;
+		std::deque<unsigned int> tasks;
+	};
+
+	unsigned int _threads;
+	std::vector<Queue> _queues;
+
+	/* Next task for thread K, stolen if need be; false once none is left */
+	bool next(unsigned int k, unsigned int& task);
+	void work(	unsigned int k, 
+				const std::function<void(unsigned int, unsigned int)>& job);
+};
+
+} // NAMESPACE_SGP
+
+#endif //_WORKERS_HH
@@ -0,0 +1,59 @@
+#include <limits.h>
+#include <sstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "batch.hh"
+#include "engine.hh"
+
+TEST(Batch, READ){
+
+	std::istringstream in(	"# g p w seed limit\n"
+							"5 3 7\n"
+							"\n"
+							"  8 4 9 42\n"
+							"6 3 8 7 1.5\n");
+	std::vector<sgp::BatchJob> jobs = sgp::read_batch(in);
+	ASSERT_EQ(jobs.size(), 3u);
+	EXPECT_EQ(jobs[0].line, 2u);
+	EXPECT_EQ(jobs[0].g, 5u);
+	EXPECT_FALSE(jobs[0].has_seed);
+	EXPECT_EQ(jobs[1].line, 4u);
+	EXPECT_TRUE(jobs[1].has_seed);
+	EXPECT_EQ(jobs[1].seed, 42u);
+	EXPECT_EQ(jobs[1].time_limit, 0.0);
+	EXPECT_EQ(jobs[2].w, 8u);
+	EXPECT_EQ(jobs[2].time_limit, 1.5);
+
+	for(const char *bad : {"5 3\n", "5 3 x\n", "0 3 7\n", "5 3 7 1 2 3\n",
+							"5 3 7 1 -1\n", "4294967297 1 1\n", 
+							"1 4294967297 1\n", "300 300 1\n", 
+							"100 100 2000\n", "5 3 7 -5\n", "5 3 7 1x\n",
+							"5 3 7 99999999999999999999\n"}){
+		std::istringstream line(bad);
+		EXPECT_THROW(sgp::read_batch(line), std::invalid_argument) << bad;
+	}
+}
+
+TEST(Batch, RUN){
+
+	std::istringstream in("5 3 7 1\n5 3 6\n4 3 5\n5 3 7 2\n");
+	std::vector<sgp::BatchJob> jobs = sgp::read_batch(in);
+	std::ostringstream out;
+	sgp::run_batch(jobs, 2, 3, [](const sgp::BatchJob& job){
+		return sgp::make_tabu_solver(sgp::TABU_LIST::DOTU, 
+									job.g, job.p, job.w, 10000, 300, 4, 100);
+	}, out);
+
+	std::istringstream records(out.str());
+	std::string line;
+	std::getline(records, line);
+	EXPECT_EQ(line[0], '#');
+	unsigned int count = 0, solved = 0;
+	while(std::getline(records, line)){
+		count++;
+		solved += line.find("\tsolved\t") != std::string::npos;
+	}
+	EXPECT_EQ(count, 4u);
+	/* 4-3-5 has no solution, 4-3 lasts at most 4 weeks */
+	EXPECT_EQ(solved, 3u);
+}
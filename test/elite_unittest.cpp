@@ -0,0 +1,100 @@
+#include <limits.h>
+#include "gtest/gtest.h"
+#include "elite.hh"
+#include "tabu.hh"
+#include "engine.hh"
+
+namespace {
+
+sgp::SGPSnapshot random_snapshot(std::uint64_t seed, unsigned int perturb)
+{
+	sgp::SGP s(5, 3, 7);
+	s.seed(seed);
+	s.init_solution();
+	s.perturb(perturb);
+	sgp::SGPSnapshot snap;
+	s.save(snap);
+	return snap;
+}
+
+}
+
+TEST(ElitePool, DISTANCE){
+
+	sgp::ElitePool pool(5, 3, 7, 4, 0);
+	sgp::SGPSnapshot a = random_snapshot(1, 0);
+	sgp::SGPSnapshot b = random_snapshot(2, 0);
+	EXPECT_EQ(pool.distance(a, a), 0u);
+	EXPECT_EQ(pool.distance(a, b), pool.distance(b, a));
+	EXPECT_GT(pool.distance(a, b), 0u);
+
+	/* relabelling groups does not move a solution */
+	sgp::SGPSnapshot c = a;
+	std::swap_ranges(c.tables.begin(), c.tables.begin() + 3, 
+										c.tables.begin() + 3);
+	EXPECT_EQ(pool.distance(a, c), 0u);
+
+	/* one swap changes at most 4 * (P - 1) pairs */
+	for(std::uint64_t seed = 1 ; seed <= 20 ; seed++){
+		EXPECT_LE(pool.distance(random_snapshot(seed, 0), 
+								random_snapshot(seed, 1)), 4u * (3 - 1));
+	}
+
+	/* the bound is strict: a neighbour at MIN_DISTANCE is kept apart */
+	sgp::SGPSnapshot d = random_snapshot(1, 1);
+	const unsigned int step = pool.distance(a, d);
+	ASSERT_GT(step, 0u);
+	sgp::ElitePool apart(5, 3, 7, 4, step);
+	ASSERT_TRUE(apart.offer(a));
+	d.eval = a.eval - 1;
+	EXPECT_TRUE(apart.offer(d));
+	EXPECT_EQ(apart.size(), 2u);
+}
+
+TEST(ElitePool, OFFER){
+
+	sgp::ElitePool pool(5, 3, 7, 2, 8);
+	sgp::Random rng(1);
+	sgp::SGPSnapshot out;
+	EXPECT_FALSE(pool.sample(rng, out));
+	EXPECT_EQ(pool.best_eval(), INT_MAX);
+
+	sgp::SGPSnapshot a = random_snapshot(1, 0);
+	EXPECT_TRUE(pool.offer(a));
+	/* a neighbour replaces A only if it is better */
+	sgp::SGPSnapshot near = a;
+	near.eval = a.eval + 1;
+	EXPECT_FALSE(pool.offer(near));
+	near.eval = a.eval - 1;
+	EXPECT_TRUE(pool.offer(near));
+	EXPECT_EQ(pool.size(), 1u);
+
+	sgp::SGPSnapshot b = random_snapshot(2, 0);
+	sgp::SGPSnapshot c = random_snapshot(3, 0);
+	ASSERT_GT(pool.distance(b, near), 8u);
+	ASSERT_GT(pool.distance(c, near), 8u);
+	ASSERT_GT(pool.distance(b, c), 8u);
+	b.eval = 100;
+	c.eval = 99;
+	EXPECT_TRUE(pool.offer(b));
+	EXPECT_TRUE(pool.offer(c));		// replaces B, the worst
+	EXPECT_EQ(pool.size(), 2u);
+	EXPECT_EQ(pool.best_eval(), near.eval);
+
+	ASSERT_TRUE(pool.sample(rng, out));
+	EXPECT_TRUE(out.tables == near.tables || out.tables == c.tables);
+	ASSERT_THROW(sgp::ElitePool(5, 3, 7, 0, 0), std::invalid_argument);
+}
+
+TEST(ElitePool, COOPERATE){
+
+	/* too hard to solve in time: every worker restarts repeatedly */
+	sgp::ElitePool pool(8, 4, 10, 4, 12);
+	auto parallel = sgp::make_parallel_tabu_solver(2, sgp::TABU_LIST::FLAT, 
+												8, 4, 10, 1000, 20, 4, 100);
+	parallel->set_elite_pool(&pool, 3);
+	parallel->seed(2);
+	parallel->run();
+	EXPECT_GT(pool.size(), 0u);
+	EXPECT_GE(pool.best_eval(), parallel->get_eval());
+}
@@ -0,0 +1,63 @@
+#include <limits.h>
+#include <sstream>
+#include "gtest/gtest.h"
+#include "grasp.hh"
+#include "engine.hh"
+
+TEST(Grasp, CONSTRUCT){
+
+	sgp::SGP greedy(8, 4, 9);
+	sgp::SGP randomized(8, 4, 9);
+	greedy.seed(3);
+	randomized.seed(3);
+
+	/* a wider candidate list trades quality for diversity */
+	int greedy_total = 0, randomized_total = 0;
+	for(int i = 0 ; i < 10 ; i++){
+		greedy.construct(1);
+		randomized.construct(8);
+		greedy_total += greedy.get_eval();
+		randomized_total += randomized.get_eval();
+	}
+	EXPECT_LE(greedy_total, randomized_total);
+
+	/* the snapshot round trip checks that every week is complete */
+	sgp::SGPSnapshot snap;
+	randomized.save(snap);
+	sgp::SGP copy(8, 4, 9);
+	copy.restore(snap);
+	EXPECT_EQ(copy.get_eval(), randomized.get_eval());
+}
+
+TEST(Grasp, SOLVE){
+
+	sgp::SGP sgp(5, 3, 7);
+	sgp::SGPGraspSolver solver(sgp, 200, 500, 3, 2, 6);
+	solver.seed(5);
+	solver.run();
+	EXPECT_EQ(sgp.get_eval(), 0);
+	EXPECT_GE(solver.iterations(), 1u);
+
+	/* same seed, same run */
+	sgp::SGP sgp2(5, 3, 7);
+	sgp::SGPGraspSolver solver2(sgp2, 200, 500, 3, 2, 6);
+	solver2.seed(5);
+	solver2.run();
+	std::stringstream s1, s2;
+	s1 << sgp;
+	s2 << sgp2;
+	EXPECT_EQ(s1.str(), s2.str());
+	EXPECT_EQ(solver.iterations(), solver2.iterations());
+}
+
+TEST(Grasp, PARALLEL){
+
+	std::unique_ptr<sgp::SGPParallelSolver> solver =
+				sgp::make_parallel_grasp_solver(2, 5, 3, 7, 200, 500, 3, 2, 6);
+	solver->seed(9);
+	solver->run();
+	EXPECT_TRUE(solver->solved());
+	EXPECT_EQ(solver->get_eval(), 0);
+	EXPECT_THROW(solver->set_init_alg(sgp::INIT_ALG::RANDOM),
+												std::invalid_argument);
+}
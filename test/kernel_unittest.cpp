@@ -0,0 +1,127 @@
+#include <limits.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "kernel.hh"
+
+namespace {
+
+const sgp::kernel::ISA all_isa[] = {	sgp::kernel::ISA::SCALAR,
+										sgp::kernel::ISA::SSE42,
+										sgp::kernel::ISA::AVX2,
+										sgp::kernel::ISA::AVX512 };
+
+/* restores the detected instruction set after each test */
+class KernelTest : public ::testing::Test{
+	protected:
+		~KernelTest(){
+			sgp::kernel::select(sgp::kernel::detect());
+		}
+};
+
+}
+
+TEST_F(KernelTest, EMPTY){
+
+	sgp::MoveChoice c = sgp::kernel::best_moves(nullptr, nullptr, 0);
+	EXPECT_EQ(c.tabu_idx, -1);
+	EXPECT_EQ(c.free_idx, -1);
+}
+
+TEST_F(KernelTest, SAME_AS_SCALAR){
+
+	std::vector<int> diff, tabu;
+	unsigned int seed = 7;
+	for(int i = 0 ; i < 1000 ; i++){
+		seed = seed * 1103515245 + 12345;
+		diff.push_back(static_cast<int>((seed >> 16) % 13) - 6);
+		tabu.push_back((seed >> 8) % 3 == 0 ? -1 : 0);
+	}
+
+	for(unsigned int n : {1u, 3u, 4u, 15u, 16u, 17u, 100u, 1000u}){
+		sgp::kernel::select(sgp::kernel::ISA::SCALAR);
+		sgp::MoveChoice ref = sgp::kernel::best_moves(	diff.data(), 
+														tabu.data(), n);
+		for(sgp::kernel::ISA isa : all_isa){
+			try{
+				sgp::kernel::select(isa);
+			}catch(const std::domain_error&){
+				continue;	// not supported by this CPU
+			}
+			sgp::MoveChoice c = sgp::kernel::best_moves(	diff.data(), 
+															tabu.data(), n);
+			EXPECT_EQ(c.free_idx, ref.free_idx) << sgp::kernel::name(isa);
+			EXPECT_EQ(c.free_diff, ref.free_diff) << sgp::kernel::name(isa);
+			EXPECT_EQ(c.tabu_idx, ref.tabu_idx) << sgp::kernel::name(isa);
+			EXPECT_EQ(c.tabu_diff, ref.tabu_diff) << sgp::kernel::name(isa);
+		}
+	}
+}
+
+TEST_F(KernelTest, LOWEST_INDEX){
+
+	std::vector<int> diff(40, 5), tabu(40, 0);
+	diff[9] = diff[33] = -2;
+	tabu[20] = tabu[30] = -1;
+	diff[20] = diff[30] = -4;
+
+	for(sgp::kernel::ISA isa : all_isa){
+		try{
+			sgp::kernel::select(isa);
+		}catch(const std::domain_error&){
+			continue;
+		}
+		sgp::MoveChoice c = sgp::kernel::best_moves(	diff.data(), 
+														tabu.data(), 40);
+		EXPECT_EQ(c.free_idx, 9) << sgp::kernel::name(isa);
+		EXPECT_EQ(c.free_diff, -2) << sgp::kernel::name(isa);
+		EXPECT_EQ(c.tabu_idx, 20) << sgp::kernel::name(isa);
+		EXPECT_EQ(c.tabu_diff, -4) << sgp::kernel::name(isa);
+	}
+}
+
+TEST_F(KernelTest, SCORE_SAME_AS_SCALAR){
+
+	/* 5 groups of 20 players: bit rows of two words */
+	const unsigned int g = 5, n = 100, a = 7, ga = 1;
+	std::vector<unsigned short> met(g * n + 1), twice(g * n + 1);
+	std::vector<std::uint64_t> once(2);
+	std::vector<int> group_of(n), b;
+	unsigned int seed = 11;
+	for(unsigned int i = 0 ; i < g * n ; i++){
+		seed = seed * 1103515245 + 12345;
+		met[i] = (seed >> 16) % 20;
+		twice[i] = (seed >> 8) % 5;
+	}
+	once[0] = 0x9e3779b97f4a7c15ull;
+	once[1] = 0x00000000ffff1234ull;
+	for(unsigned int x = 0 ; x < n ; x++){
+		group_of[x] = (x * 3) % g;
+		if(group_of[x] != static_cast<int>(ga))
+			b.push_back(x);
+	}
+	const sgp::SwapRows rows = {	met.data(), twice.data(), once.data(),
+									group_of.data(), n, a, ga};
+
+	std::vector<int> expected(b.size());
+	for(unsigned int k = 0 ; k < b.size() ; k++){
+		const unsigned int x = b[k], gx = group_of[x];
+		expected[k] = 	met[ga * n + x] - twice[ga * n + a] + 
+						met[gx * n + a] - twice[gx * n + x] -
+						2 * static_cast<int>((once[x / 64] >> (x % 64)) & 1);
+	}
+	for(unsigned int count : {0u, 1u, 7u, 8u, 17u, 
+								static_cast<unsigned int>(b.size())}){
+		for(sgp::kernel::ISA isa : all_isa){
+			try{
+				sgp::kernel::select(isa);
+			}catch(const std::domain_error&){
+				continue;
+			}
+			std::vector<int> diff(count + 1, 12345);
+			sgp::kernel::score_swaps(rows, b.data(), count, diff.data());
+			for(unsigned int k = 0 ; k < count ; k++)
+				EXPECT_EQ(diff[k], expected[k]) << sgp::kernel::name(isa);
+			EXPECT_EQ(diff[count], 12345) << sgp::kernel::name(isa);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#include <limits.h>
+#include <sstream>
+#include <numeric>
+#include "gtest/gtest.h"
+#include "lns.hh"
+#include "engine.hh"
+
+TEST(Lns, SET_WEEK){
+
+	sgp::SGP sgp(8, 4, 9);
+	sgp.seed(2);
+	sgp.init_solution();
+
+	std::vector<int> canonical(32);
+	std::iota(canonical.begin(), canonical.end(), 0);
+	const int eval = sgp.get_eval();
+	const unsigned int before = sgp.week_conflicts(3);
+	sgp.set_week(3, canonical.data());
+	EXPECT_EQ(sgp.get_eval() - eval,
+			static_cast<int>(sgp.week_conflicts(3)) - static_cast<int>(before));
+
+	/* incremental bookkeeping agrees with a bulk rebuild */
+	sgp::SGPSnapshot snap;
+	sgp.save(snap);
+	sgp::SGP rebuilt(8, 4, 9);
+	rebuilt.restore(snap);
+	std::stringstream s1, s2;
+	s1 << sgp;
+	s2 << rebuilt;
+	EXPECT_EQ(s1.str(), s2.str());
+	for(unsigned int w = 0 ; w < 9 ; w++)
+		EXPECT_EQ(sgp.week_conflicts(w), rebuilt.week_conflicts(w));
+}
+
+TEST(Lns, REPAIR){
+
+	sgp::SGP sgp(8, 4, 3);
+	sgp.seed(6);
+	sgp.init_solution();
+	sgp::Random rng(1);
+	sgp::WeekRepair repair(8, 4);
+	std::vector<sgp::bits::word> met;
+
+	/* three weeks of 8-4 are easy: each repair reaches cost 0 */
+	for(unsigned int w = 0 ; w < 3 ; w++){
+		const unsigned int cost = sgp.week_conflicts(w);
+		sgp.met_outside_week(w, met);
+		ASSERT_TRUE(repair.search(met, cost + 1, 1000000, rng));
+		EXPECT_LE(repair.cost(), cost);
+		sgp.set_week(w, repair.week().data());
+		EXPECT_EQ(sgp.week_conflicts(w), repair.cost());
+	}
+	EXPECT_EQ(sgp.get_eval(), 0);
+
+	/* nothing beats a conflict-free week */
+	sgp.met_outside_week(0, met);
+	EXPECT_FALSE(repair.search(met, 0, 1000000, rng));
+}
+
+TEST(Lns, SOLVE){
+
+	sgp::SGP sgp(8, 4, 7);
+	sgp::SGPLnsSolver solver(sgp, 200, 2, 20000, 100, 4, 100);
+	solver.seed(4);
+	solver.run();
+	EXPECT_EQ(sgp.get_eval(), 0);
+
+	std::unique_ptr<sgp::SGPInstanceSolver> owned =
+			sgp::make_lns_solver(5, 3, 7, 200, 2, 20000, 100, 4, 100);
+	owned->seed(4);
+	owned->run();
+	EXPECT_EQ(owned->get_eval(), 0);
+	EXPECT_TRUE(owned->fixed());
+}
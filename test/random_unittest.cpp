@@ -0,0 +1,50 @@
+#include <limits.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "random.hh"
+
+TEST(Random, SAME_SEED){
+
+	sgp::Random a(42), b(42), c(43);
+	bool differ = false;
+	for(int i = 0 ; i < 100 ; i++){
+		const std::uint64_t x = a.next();
+		EXPECT_EQ(x, b.next());
+		differ |= x != c.next();
+	}
+	EXPECT_TRUE(differ);
+
+	a.seed(42);
+	b.seed(42);
+	EXPECT_EQ(a(1000), b(1000));
+}
+
+TEST(Random, BOUNDED){
+
+	sgp::Random rng(1);
+	EXPECT_EQ(rng(0), 0u);
+	EXPECT_EQ(rng(1), 0u);
+
+	std::vector<unsigned int> hits(7, 0);
+	for(int i = 0 ; i < 7000 ; i++){
+		unsigned int v = rng(7);
+		ASSERT_LT(v, 7u);
+		hits[v]++;
+	}
+	for(unsigned int h : hits)
+		EXPECT_GT(h, 800u);
+
+	for(int i = 0 ; i < 1000 ; i++){
+		ASSERT_LT(rng(UINT_MAX), UINT_MAX);
+		double u = rng.uniform();
+		ASSERT_GE(u, 0.0);
+		ASSERT_LT(u, 1.0);
+	}
+}
+
+TEST(Random, DERIVE){
+
+	EXPECT_EQ(sgp::Random::derive(5, 1), sgp::Random::derive(5, 1));
+	EXPECT_NE(sgp::Random::derive(5, 0), sgp::Random::derive(5, 1));
+	EXPECT_NE(sgp::Random::derive(5, 1), sgp::Random::derive(6, 1));
+}
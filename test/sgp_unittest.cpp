@@ -1,7 +1,13 @@
 #include <limits.h>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
 #include "gtest/gtest.h"
 #include "sgp.hh"
 #include "tabu.hh"
+#include "stats.hh"
 
 extern sgp::SGP sgp1;
 
@@ -12,17 +18,6 @@ class SGPTest : public ::testing::Test{
 		SGP sgp;
 		SGPTest() : sgp(8 , 4, 9) {}
 
-		void inline clean_conf(){
-			for(auto 	iter = sgp.conflict_set.begin();
-						iter != sgp.conflict_set.end() ; iter++ ){
-			while(iter->erased){
-				iter = sgp.conflict_set.erase(iter);
-				if(iter == sgp.conflict_set.end())
-					return;
-			}
-			}
-		}
-
 };
 
 TEST_F(SGPTest, INIT_TEST)
@@ -48,6 +43,294 @@ TEST_F(SGPTest, INIT_TEST)
 	}
 }
 
+TEST_F(SGPTest, CONFLICT_SET)
+{
+	sgp.init_solution();
+	sgp::SGPDotuTabuList tlist(sgp, 2, 6);
+
+	for(int i = 0 ; i < 200 ; i++){
+		sgp.local_search(tlist, sgp.get_eval());
+		tlist.incr_iteration();
+	}
+
+	for(unsigned int w = 0 ; w < sgp.w() ; w++){
+		for(unsigned int p = 0 ; p < sgp.g() * sgp.p() ; p++){
+			int g = sgp._groups[w][p];
+			ASSERT_NE(g, -1);
+			EXPECT_EQ(sgp.conflict_set.contains(w, p), 
+					sgp.calc_conflicts_player_in_group(w, g, p) > 0);
+		}
+	}
+}
+
+TEST_F(SGPTest, SWAP_DIFF)
+{
+	sgp.init_solution();
+	sgp::SGPDotuTabuList tlist(sgp, 2, 6);
+
+	for(int i = 0 ; i < 50 ; i++){
+		sgp.local_search(tlist, sgp.get_eval());
+		tlist.incr_iteration();
+	}
+
+	for(unsigned int w = 0 ; w < sgp.w() ; w++){
+		for(unsigned int a = 0 ; a < sgp.g() * sgp.p() ; a++){
+			for(unsigned int b = 0 ; b < sgp.g() * sgp.p() ; b++){
+				int ga = sgp._groups[w][a];
+				int gb = sgp._groups[w][b];
+				if(ga == gb)
+					continue;
+				EXPECT_EQ(sgp.calc_swap_diff(w, a, ga, b, gb),
+						sgp.calc_conflicts_diff_in_group(w, ga, a, b) + 
+						sgp.calc_conflicts_diff_in_group(w, gb, b, a));
+			}
+		}
+	}
+}
+
+TEST_F(SGPTest, SEED)
+{
+	SGP sgp2(8, 4, 9);
+	sgp.seed(11);
+	sgp2.seed(11);
+	sgp.init_solution();
+	sgp2.init_solution();
+
+	std::stringstream s1, s2;
+	s1 << sgp;
+	s2 << sgp2;
+	EXPECT_EQ(s1.str(), s2.str());
+}
+
+TEST_F(SGPTest, MOVE)
+{
+	/* the constructors take the solution and the stream, not the hooks */
+	SearchStats stats;
+	sgp.seed(3);
+	sgp.init_solution();
+	sgp.set_stats(&stats);
+	SGP copy(sgp);
+	SGP moved(std::move(sgp));
+	EXPECT_EQ(moved.get_eval(), copy.get_eval());
+	EXPECT_EQ(moved.rng().next(), copy.rng().next());
+
+	SGPFlatTabuList tlist(moved, 4, 6);
+	moved.local_search(tlist, moved.get_eval());
+	copy.local_search(tlist, copy.get_eval());
+	EXPECT_EQ(stats.moves_evaluated, 0u);
+}
+
+TEST_F(SGPTest, GREEDY)
+{
+	SGP random(8, 4, 9);
+	sgp.set_init_alg(INIT_ALG::GREEDY);
+	int greedy_total = 0, random_total = 0;
+	for(unsigned int s = 0 ; s < 10 ; s++){
+		sgp.seed(s);
+		random.seed(s);
+		sgp.init_solution();
+		random.init_solution();
+		greedy_total += sgp.get_eval();
+		random_total += random.get_eval();
+
+		/* every week is a partition of the players */
+		for(unsigned int w = 0 ; w < 9 ; w++){
+			std::vector<int> seen(32, 0);
+			for(unsigned int g = 0 ; g < 8 ; g++){
+				ASSERT_EQ(sgp.group_end(w, g) - sgp.group_begin(w, g), 4);
+				for(const int *p = sgp.group_begin(w, g); 
+									p != sgp.group_end(w, g); ++p)
+					seen[*p]++;
+			}
+			EXPECT_EQ(seen, std::vector<int>(32, 1));
+		}
+	}
+	EXPECT_LT(greedy_total, random_total);
+
+	/* the first weeks can be built without conflicts */
+	SGP small(8, 4, 3);
+	small.set_init_alg(INIT_ALG::GREEDY);
+	small.seed(1);
+	small.init_solution();
+	EXPECT_EQ(small.get_eval(), 0);
+}
+
+TEST_F(SGPTest, SYMMETRY)
+{
+	sgp.set_symmetry(SYMMETRY::FIRST_WEEK_AND_GROUP);
+	EXPECT_EQ(sgp.frozen_groups(0), 8u);
+	EXPECT_EQ(sgp.frozen_groups(1), 1u);
+	EXPECT_EQ(sgp.frozen_groups(2), 0u);
+
+	for(INIT_ALG alg : {INIT_ALG::RANDOM, INIT_ALG::GREEDY}){
+		sgp.set_init_alg(alg);
+		sgp.seed(3);
+		sgp.init_solution();
+		sgp::SGPDotuTabuList tlist(sgp, 2, 6);
+		for(int i = 0 ; i < 200 ; i++){
+			sgp.local_search(tlist, sgp.get_eval());
+			tlist.incr_iteration();
+		}
+		sgp.perturb(50);
+
+		/* pinned cells did not move and never entered the conflict set */
+		for(unsigned int x = 0 ; x < 32 ; x++)
+			EXPECT_EQ(sgp._tables[x], static_cast<int>(x));
+		for(unsigned int i = 0 ; i < 4 ; i++)
+			EXPECT_EQ(sgp.group_begin(1, 0)[i], static_cast<int>(4 * i));
+		for(const ConflictSet::cell &c : sgp.conflict_set)
+			EXPECT_FALSE(sgp.frozen(c.w, c.player));
+		for(unsigned int w = 0 ; w < 9 ; w++){
+			for(unsigned int x = 0 ; x < 32 ; x++){
+				EXPECT_EQ(sgp.conflict_set.contains(w, x), 
+					!sgp.frozen(w, x) && sgp.calc_conflicts_player_in_group(
+										w, sgp._groups[w][x], x) > 0);
+			}
+		}
+	}
+
+	SGP wide(3, 4, 5);
+	EXPECT_THROW(wide.set_symmetry(SYMMETRY::FIRST_WEEK_AND_GROUP), 
+												std::invalid_argument);
+}
+
+TEST_F(SGPTest, SNAPSHOT)
+{
+	sgp.seed(4);
+	sgp.init_solution();
+	SGPSnapshot snap;
+	sgp.save(snap);
+	std::stringstream before;
+	before << sgp;
+
+	sgp::SGPDotuTabuList tlist(sgp, 2, 6);
+	for(int i = 0 ; i < 50 ; i++){
+		sgp.local_search(tlist, sgp.get_eval());
+		tlist.incr_iteration();
+	}
+
+	sgp.restore(snap);
+	std::stringstream after;
+	after << sgp;
+	EXPECT_EQ(before.str(), after.str());
+	EXPECT_EQ(sgp.get_eval(), snap.eval);
+	for(unsigned int w = 0 ; w < 9 ; w++){
+		for(unsigned int x = 0 ; x < 32 ; x++){
+			EXPECT_EQ(sgp.conflict_set.contains(w, x),
+				sgp.calc_conflicts_player_in_group(w, sgp._groups[w][x], x) 
+																		> 0);
+		}
+	}
+
+	SGP other(4, 4, 4);
+	ASSERT_THROW(other.restore(snap), std::invalid_argument);
+
+	/* corrupted snapshots are rejected, the instance is left as it was */
+	SGPSnapshot bad = snap;
+	bad.tables[3] = 100000;
+	EXPECT_THROW(sgp.restore(bad), std::invalid_argument);
+	bad.tables[3] = bad.tables[4];
+	EXPECT_THROW(sgp.restore(bad), std::invalid_argument);
+	std::stringstream unchanged;
+	unchanged << sgp;
+	EXPECT_EQ(before.str(), unchanged.str());
+	bad = snap;
+	bad.eval++;
+	EXPECT_THROW(sgp.restore(bad), std::invalid_argument);
+}
+
+TEST_F(SGPTest, REBUILD)
+{
+	sgp.seed(8);
+	sgp.init_solution();
+
+	/* same solution built incrementally */
+	SGP inc(8, 4, 9);
+	for(unsigned int w = 0 ; w < 9 ; w++)
+		for(unsigned int g = 0 ; g < 8 ; g++)
+			for(const int *p = sgp.group_begin(w, g); 
+								p != sgp.group_end(w, g); ++p)
+				inc.set_field(w, g, UNSET, *p);
+
+	std::stringstream s1, s2;
+	s1 << sgp;
+	s2 << inc;
+	EXPECT_EQ(s1.str(), s2.str());
+	EXPECT_EQ(sgp._met_in_group, inc._met_in_group);
+	EXPECT_EQ(sgp._twice_in_group, inc._twice_in_group);
+	EXPECT_EQ(sgp._met_once, inc._met_once);
+	EXPECT_EQ(sgp._met_twice, inc._met_twice);
+	EXPECT_EQ(sgp._group_mask, inc._group_mask);
+	EXPECT_EQ(sgp._groups, inc._groups);
+	EXPECT_EQ(sgp.conflict_set.size(), inc.conflict_set.size());
+	for(const ConflictSet::cell &c : inc.conflict_set)
+		EXPECT_TRUE(sgp.conflict_set.contains(c.w, c.player));
+
+	/* moving keeps the solution */
+	SGP moved(std::move(inc));
+	EXPECT_EQ(moved.get_eval(), sgp.get_eval());
+	SGP assigned(8, 4, 9);
+	assigned = std::move(moved);
+	std::stringstream s3;
+	s3 << assigned;
+	EXPECT_EQ(s1.str(), s3.str());
+}
+
+TEST_F(SGPTest, PARALLEL_SCAN)
+{
+	SGP serial(10, 10, 4), split(10, 10, 4);
+	WorkerPool pool(3);
+	split.set_worker_pool(&pool);
+	serial.seed(6);
+	split.seed(6);
+	serial.init_solution();
+	split.init_solution();
+	ASSERT_GE(split.conflict_set.size() * 9 * 10, 4096u);
+
+	sgp::SGPFlatTabuList t1(serial, 2, 6), t2(split, 2, 6);
+	t1.seed(1);
+	t2.seed(1);
+	for(int i = 0 ; i < 30 ; i++){
+		serial.local_search(t1, serial.get_eval());
+		split.local_search(t2, split.get_eval());
+		t1.incr_iteration();
+		t2.incr_iteration();
+	}
+	std::stringstream s1, s2;
+	s1 << serial;
+	s2 << split;
+	EXPECT_EQ(s1.str(), s2.str());
+}
+
+TEST_F(SGPTest, KERNELS)
+{
+	/* every scoring kernel takes the same moves as the scalar one */
+	std::string ref;
+	for(kernel::ISA isa : {	kernel::ISA::SCALAR, kernel::ISA::SSE42, 
+							kernel::ISA::AVX2, kernel::ISA::AVX512}){
+		try{
+			kernel::select(isa);
+		}catch(const std::domain_error&){
+			continue;
+		}
+		SGP large(10, 10, 4);
+		large.seed(3);
+		large.init_solution();
+		sgp::SGPDotuTabuList tlist(large, 2, 6);
+		tlist.seed(1);
+		for(int i = 0 ; i < 200 ; i++){
+			large.local_search(tlist, large.get_eval());
+			tlist.incr_iteration();
+		}
+		std::stringstream out;
+		out << large;
+		if(isa == kernel::ISA::SCALAR)
+			ref = out.str();
+		EXPECT_EQ(ref, out.str()) << kernel::name(isa);
+	}
+	kernel::select(kernel::detect());
+}
+
 TEST_F(SGPTest, EVAL){
 
 	EXPECT_EQ( sgp.get_eval(), 0);
@@ -148,42 +431,26 @@ TEST_F(SGPTest, SET_FIELD)
 
 	sgp.set_field(1,0,0,8);
 	EXPECT_EQ(sgp.best_eval , 3);	
-	EXPECT_EQ(sgp.conflict_set.size() , 8);	
-	decision elem(1, 0, 0);
-	auto iter = sgp.conflict_set.find(elem);	
-	EXPECT_TRUE(iter->erased );	
-	clean_conf();
 	EXPECT_EQ(sgp.conflict_set.size() , 6);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 0));	
 
 
 	sgp.set_field(1,0,1,9);
 	EXPECT_EQ(sgp.best_eval , 1);	
-	EXPECT_EQ(sgp.conflict_set.size() , 6);	
-	elem.val = 1;
-	iter = sgp.conflict_set.find(elem);	
-	EXPECT_TRUE(iter->erased);	
-	clean_conf();
 	EXPECT_EQ(sgp.conflict_set.size() , 4);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 1));	
 
 
 	sgp.set_field(1,0,2,10);
 	EXPECT_EQ(sgp.best_eval , 0);	
-	EXPECT_EQ(sgp.conflict_set.size() , 4);	
-	elem.val = 2;
-	iter = sgp.conflict_set.find(elem);	
-	EXPECT_TRUE(iter->erased);	
-	clean_conf();
 	EXPECT_EQ(sgp.conflict_set.size() , 0);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 2));	
 
 
 	sgp.set_field(1,0,3,11);
 	EXPECT_EQ(sgp.best_eval , 0);	
 	EXPECT_EQ(sgp.conflict_set.size() , 0);	
-	elem.val = 3;
-	iter = sgp.conflict_set.find(elem);	
-	EXPECT_EQ(iter, sgp.conflict_set.end());	
-	clean_conf();
-	EXPECT_EQ(sgp.conflict_set.size() , 0);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 3));	
 
 
 	EXPECT_TRUE(true);	
@@ -252,42 +519,26 @@ EXPECT_EQ(sgp.best_eval , 0);
 
 	sgp.set_field(1,0,0,8);
 	EXPECT_EQ(sgp.best_eval , 3);	
-	EXPECT_EQ(sgp.conflict_set.size() , 8);	
-	decision elem(1, 0, 0);
-	auto iter = sgp.conflict_set.find(elem);	
-	EXPECT_TRUE(iter->erased );	
-	clean_conf();
 	EXPECT_EQ(sgp.conflict_set.size() , 6);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 0));	
 
 
 	sgp.set_field(1,0,1,9);
 	EXPECT_EQ(sgp.best_eval , 1);	
-	EXPECT_EQ(sgp.conflict_set.size() , 6);	
-	elem.val = 1;
-	iter = sgp.conflict_set.find(elem);	
-	EXPECT_TRUE(iter->erased);	
-	clean_conf();
 	EXPECT_EQ(sgp.conflict_set.size() , 4);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 1));	
 
 
 	sgp.set_field(1,0,2,10);
 	EXPECT_EQ(sgp.best_eval , 0);	
-	EXPECT_EQ(sgp.conflict_set.size() , 4);	
-	elem.val = 2;
-	iter = sgp.conflict_set.find(elem);	
-	EXPECT_TRUE(iter->erased);	
-	clean_conf();
 	EXPECT_EQ(sgp.conflict_set.size() , 0);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 2));	
 
 
 	sgp.set_field(1,0,3,11);
 	EXPECT_EQ(sgp.best_eval , 0);	
 	EXPECT_EQ(sgp.conflict_set.size() , 0);	
-	elem.val = 3;
-	iter = sgp.conflict_set.find(elem);	
-	EXPECT_EQ(iter, sgp.conflict_set.end());	
-	clean_conf();
-	EXPECT_EQ(sgp.conflict_set.size() , 0);	
+	EXPECT_FALSE(sgp.conflict_set.contains(1, 3));	
 
 
 	//calc swap of 0<->8
@@ -322,3 +573,69 @@ EXPECT_EQ(sgp.best_eval , 0);
 }
 
 }
+
+TEST(WorkerPool, RUN){
+
+	sgp::WorkerPool pool(4);
+	EXPECT_EQ(pool.threads(), 4u);
+	std::vector<int> hits(100, 0);
+	for(int round = 0 ; round < 50 ; round++)
+		pool.run(100, [&](unsigned int t){ hits[t]++; });
+	for(int h : hits)
+		EXPECT_EQ(h, 50);
+	pool.run(0, [&](unsigned int){ FAIL(); });
+	ASSERT_THROW(sgp::WorkerPool(0), std::invalid_argument);
+}
+
+TEST(StealingPool, RUN){
+
+	sgp::StealingPool pool(3);
+	EXPECT_EQ(pool.threads(), 3u);
+	std::vector<std::atomic<int>> hits(40);
+	std::atomic<bool> bad_worker(false);
+	/* the long tasks are all dealt to worker 0, the others steal them */
+	pool.run(40, [&](unsigned int t, unsigned int k){
+		if(t % 3 == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		if(k >= 3)
+			bad_worker = true;
+		hits[t]++;
+	});
+	for(const std::atomic<int> &h : hits)
+		EXPECT_EQ(h.load(), 1);
+	EXPECT_FALSE(bad_worker.load());
+	pool.run(0, [&](unsigned int, unsigned int){ FAIL(); });
+	ASSERT_THROW(sgp::StealingPool(0), std::invalid_argument);
+}
+
+TEST(ConflictSet, SAMPLE){
+
+	sgp::ConflictSet set(3, 4);
+	for(unsigned int w = 0 ; w < 3 ; w++){
+		set.insert(w, w);
+		set.insert(w, 3);
+	}
+	set.erase(1, 3);
+	ASSERT_EQ(set.size(), 5u);
+
+	/* DRAW gets the size and picks the member at that position */
+	unsigned int asked = 0;
+	const sgp::ConflictSet::cell &last = set.sample(
+				[&](unsigned int n){ asked = n; return n - 1; });
+	EXPECT_EQ(asked, 5u);
+	EXPECT_EQ(last.w, set[4].w);
+	EXPECT_EQ(last.player, set[4].player);
+
+	/* every member is drawn, none more than its share allows */
+	sgp::Random rng(7);
+	std::vector<int> hits(3 * 4, 0);
+	for(int i = 0 ; i < 5000 ; i++){
+		const sgp::ConflictSet::cell &c = set.sample(rng);
+		ASSERT_TRUE(set.contains(c.w, c.player));
+		hits[c.w * 4 + c.player]++;
+	}
+	for(const sgp::ConflictSet::cell &c : set){
+		EXPECT_GT(hits[c.w * 4 + c.player], 800);
+		EXPECT_LT(hits[c.w * 4 + c.player], 1200);
+	}
+}
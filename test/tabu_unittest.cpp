@@ -1,6 +1,11 @@
 #include <limits.h>
+#include <sstream>
+#include <cstdio>
 #include "gtest/gtest.h"
 #include "tabu.hh"
+#include "engine.hh"
+#include "checkpoint.hh"
+#include "elite.hh"
 
 sgp::SGP sgp1(8, 4, 10);
 
@@ -132,3 +137,342 @@ TEST(TabuList, CLEARALL){
 	EXPECT_FALSE(tlist.is_tabu(2 , 2 , 3)); 
 	EXPECT_FALSE(tlist.is_tabu(2 , 3 , 4)); 
 }
+
+TEST(FlatTabuList, ADD){
+
+	sgp::SGPFlatTabuList tlist(sgp1);
+	ASSERT_THROW( tlist.add(-1 , 0, 0), std::domain_error );
+	ASSERT_THROW( tlist.add( 10 , 0, 0), std::domain_error );
+	ASSERT_THROW( tlist.add( 1 , 0, 32), std::domain_error );
+	ASSERT_NO_THROW (tlist.add(1 , 0, 1));
+}
+
+TEST(FlatTabuList, IS_TABU){
+		
+	sgp::SGPFlatTabuList tlist(sgp1, 4 , 6);
+	ASSERT_THROW(tlist.is_tabu(-1, 0 , 0), std::domain_error);
+	EXPECT_FALSE(tlist.is_tabu(0 , 1 , 1)); 
+	
+	ASSERT_NO_THROW(tlist.add(1, 0 ,1));
+	EXPECT_FALSE(tlist.is_tabu(0 , 0 , 1)); 
+	EXPECT_FALSE(tlist.is_tabu(1 , 0 , 2)); 
+	
+	for( int i = 0; i < 4; i++){
+		EXPECT_TRUE(tlist.is_tabu(1 , 0 , 1)); 
+		EXPECT_TRUE(tlist.is_tabu(1 , 1 , 0));
+	   	tlist.incr_iteration();	
+	}
+
+	for( int i = 0; i < 2; i++)
+	   	tlist.incr_iteration();	
+
+	EXPECT_FALSE(tlist.is_tabu(1 , 0 , 1)); 
+	EXPECT_FALSE(tlist.is_tabu(1 , 1 , 0));
+}
+
+TEST(FlatTabuList, CLEAR){
+
+	sgp::SGPFlatTabuList tlist(sgp1, 4 , 6);
+
+	ASSERT_NO_THROW(tlist.add(1, 0 ,1));
+	ASSERT_NO_THROW(tlist.add(2, 2 ,3));
+	ASSERT_THROW(tlist.clear(-1), std::domain_error);
+
+	ASSERT_NO_THROW(tlist.clear(1));
+	EXPECT_FALSE(tlist.is_tabu(1 , 0 , 1)); 
+	EXPECT_TRUE(tlist.is_tabu(2 , 2 , 3)); 
+}
+
+TEST(FlatTabuList, CLEARALL){
+
+	sgp::SGPFlatTabuList tlist(sgp1, 4 , 6);
+
+	ASSERT_NO_THROW(tlist.add(1, 0 ,1));
+	ASSERT_NO_THROW(tlist.add(2, 3 ,31));
+	EXPECT_TRUE(tlist.is_tabu(1 , 0 , 1)); 
+	EXPECT_TRUE(tlist.is_tabu(2 , 31 , 3)); 
+	
+	ASSERT_NO_THROW(tlist.clearAll());
+	EXPECT_FALSE(tlist.is_tabu(1 , 0 , 1)); 
+	EXPECT_FALSE(tlist.is_tabu(2 , 3 , 31)); 
+
+	ASSERT_NO_THROW(tlist.add(1, 0 ,1));
+	EXPECT_TRUE(tlist.is_tabu(1 , 0 , 1)); 
+}
+
+TEST(TabuSolver, SEED){
+
+	sgp::SGP a(5, 3, 5), b(5, 3, 5);
+	sgp::SGPFlatTabuSolver sa(a, 2000, 100), sb(b, 2000, 100);
+	sa.seed(3);
+	sb.seed(3);
+	sa.run();
+	sb.run();
+	EXPECT_EQ(sa.iterations(), sb.iterations());
+	EXPECT_EQ(sa.restarts(), sb.restarts());
+	EXPECT_EQ(a.get_eval(), b.get_eval());
+	/* a cycle lasts more than max_stable tries */
+	EXPECT_LE(sa.restarts() * 101, sa.iterations());
+}
+
+TEST(TabuSolver, FIXED_ENGINE){
+
+	auto fixed = sgp::make_tabu_solver(sgp::TABU_LIST::FLAT, 5, 3, 7, 
+														500, 100, 4, 100);
+	auto dynamic = sgp::make_tabu_solver(sgp::TABU_LIST::FLAT, 5, 3, 7, 
+													500, 100, 4, 100, true);
+	EXPECT_TRUE(fixed->fixed());
+	EXPECT_FALSE(dynamic->fixed());
+	EXPECT_FALSE(sgp::make_tabu_solver(sgp::TABU_LIST::DOTU, 5, 3, 6, 
+												500, 100, 4, 100)->fixed());
+
+	/* both engines walk the same trajectory */
+	fixed->seed(9);
+	dynamic->seed(9);
+	fixed->run();
+	dynamic->run();
+	std::stringstream s1, s2;
+	fixed->print(s1);
+	dynamic->print(s2);
+	EXPECT_EQ(s1.str(), s2.str());
+	EXPECT_EQ(fixed->iterations(), dynamic->iterations());
+
+	typedef sgp::FixedSGP<5, 3, 7> SGP537;
+	ASSERT_THROW(SGP537(5, 3, 6), std::invalid_argument);
+}
+
+TEST(TabuSolver, PARALLEL){
+
+	auto parallel = sgp::make_parallel_tabu_solver(4, sgp::TABU_LIST::FLAT, 
+												5, 3, 7, 20000, 100, 4, 100);
+	EXPECT_EQ(parallel->workers(), 4u);
+	parallel->seed(1);
+	parallel->run();
+	EXPECT_TRUE(parallel->solved());
+	EXPECT_LT(parallel->winner(), 4u);
+	EXPECT_EQ(parallel->get_eval(), 0);
+	EXPECT_GE(parallel->runtime(), 0.0);
+
+	/* a raised flag stops a solver before its first move */
+	std::atomic<bool> cancel(true);
+	auto single = sgp::make_tabu_solver(sgp::TABU_LIST::DOTU, 8, 4, 10, 
+														1000, 100, 4, 100);
+	single->set_cancel(&cancel);
+	single->run();
+	EXPECT_EQ(single->iterations(), 0u);
+}
+
+TEST(TabuSolver, PARALLEL_ERROR){
+
+	/* a worker mixing an elite pool with checkpoints throws from run() */
+	sgp::ElitePool pool(8, 4, 10, 2, 0);
+	std::vector<std::unique_ptr<sgp::SGPInstanceSolver>> workers;
+	workers.push_back(sgp::make_tabu_solver(sgp::TABU_LIST::FLAT, 
+											8, 4, 10, 1000000, 100, 4, 100));
+	workers.push_back(sgp::make_tabu_solver(sgp::TABU_LIST::FLAT, 
+											8, 4, 10, 1000000, 100, 4, 100));
+	workers[1]->set_elite_pool(&pool, 10);
+	workers[1]->set_checkpoint("parallel_error.ckpt", 1);
+	sgp::SGPParallelSolver parallel(std::move(workers));
+	parallel.seed(1);
+	EXPECT_THROW(parallel.run(), std::invalid_argument);
+}
+
+TEST(TabuSolver, STATS){
+
+	sgp::SGP sgp(8, 4, 9);
+	sgp::SGPDotuTabuSolver solver(sgp, 3000, 100);
+	solver.seed(5);
+	solver.run();
+	const sgp::SearchStats &stats = solver.stats();
+	EXPECT_EQ(stats.iterations, solver.iterations());
+	EXPECT_EQ(stats.restarts, solver.restarts());
+	EXPECT_EQ(stats.best_eval, sgp.get_eval());
+	EXPECT_LE(stats.iterations_to_best, stats.iterations);
+	EXPECT_GT(stats.moves_evaluated, 0u);
+	EXPECT_GT(stats.peak_conflicts, 0u);
+	EXPECT_LE(stats.aspirations + stats.tabu_rejections, 
+				static_cast<std::uint64_t>(stats.iterations));
+	/* the trajectory starts at the initial solution and only improves */
+	ASSERT_FALSE(stats.milestones.empty());
+	EXPECT_EQ(stats.milestones[0].iteration, 0u);
+	for(std::size_t i = 1 ; i < stats.milestones.size() ; i++)
+		EXPECT_LT(stats.milestones[i].eval, stats.milestones[i - 1].eval);
+	EXPECT_EQ(stats.milestones.back().eval, stats.best_eval);
+
+	std::stringstream json;
+	stats.print_json(json);
+	EXPECT_EQ(json.str().front(), '{');
+	EXPECT_EQ(json.str().back(), '}');
+	EXPECT_NE(json.str().find("\"milestones\": [{"), std::string::npos);
+}
+
+TEST(TabuSolver, TIME_LIMIT){
+
+	/* far from solvable: only the limit ends the run */
+	auto solver = sgp::make_tabu_solver(sgp::TABU_LIST::FLAT, 8, 4, 11, 
+											100000000, 100, 4, 100);
+	solver->set_time_limit(0.2);
+	solver->seed(2);
+	solver->run();
+	EXPECT_TRUE(solver->stats().timed_out);
+	EXPECT_GE(solver->wall_time(), 0.2);
+	/* the best solution so far is kept */
+	EXPECT_EQ(solver->get_eval(), solver->stats().best_eval);
+	EXPECT_LT(solver->iterations(), 100000000u);
+
+	auto parallel = sgp::make_parallel_tabu_solver(2, sgp::TABU_LIST::FLAT,
+											8, 4, 11, 100000000, 100, 4, 100);
+	parallel->set_time_limit(0.2);
+	parallel->run();
+	EXPECT_FALSE(parallel->solved());
+	EXPECT_GE(parallel->wall_time(), 0.2);
+	EXPECT_TRUE(parallel->stats().timed_out);
+	EXPECT_LT(parallel->iterations(), 200000000u);
+}
+
+TEST(TabuList, SAVE_LOAD){
+
+	sgp::SGPDotuTabuList dotu(sgp1, 4, 20);
+	sgp::SGPFlatTabuList flat(sgp1, 4, 20);
+	dotu.seed(3);
+	flat.seed(3);
+	for(unsigned int i = 0 ; i < 30 ; i++){
+		dotu.add(i % 10, i % 32, (i * 7 + 1) % 32);
+		flat.add(i % 10, i % 32, (i * 7 + 1) % 32);
+		dotu.incr_iteration();
+		flat.incr_iteration();
+	}
+	std::stringstream dotu_state, flat_state;
+	dotu.save(dotu_state);
+	flat.save(flat_state);
+
+	sgp::SGPDotuTabuList dotu_copy(sgp1, 4, 20);
+	sgp::SGPFlatTabuList flat_copy(sgp1, 4, 20);
+	ASSERT_NO_THROW(dotu_copy.load(dotu_state));
+	ASSERT_NO_THROW(flat_copy.load(flat_state));
+	/* same tabu moves now, and the same tenures drawn from now on */
+	for(unsigned int i = 0 ; i < 25 ; i++){
+		dotu.add(i % 10, 31 - i, i);
+		dotu_copy.add(i % 10, 31 - i, i);
+		flat.add(i % 10, 31 - i, i);
+		flat_copy.add(i % 10, 31 - i, i);
+		for(unsigned int w = 0 ; w < 10 ; w++){
+			for(unsigned int a = 0 ; a < 32 ; a++){
+				for(unsigned int b = a + 1 ; b < 32 ; b++){
+					ASSERT_EQ(dotu.is_tabu(w, a, b), dotu_copy.is_tabu(w, a, b));
+					ASSERT_EQ(flat.is_tabu(w, a, b), flat_copy.is_tabu(w, a, b));
+				}
+			}
+		}
+		dotu.incr_iteration();
+		dotu_copy.incr_iteration();
+		flat.incr_iteration();
+		flat_copy.incr_iteration();
+	}
+
+	/* the state of another kind of list or instance */
+	std::stringstream state;
+	flat.save(state);
+	EXPECT_THROW(dotu_copy.load(state), std::invalid_argument);
+	sgp::SGP other(5, 3, 7);
+	sgp::SGPFlatTabuList other_list(other);
+	state.clear();
+	state.seekg(0);
+	EXPECT_THROW(other_list.load(state), std::invalid_argument);
+}
+
+TEST(TabuSolver, RESUME){
+
+	const std::string path = "tabu_resume.ckpt";
+	for(sgp::TABU_LIST list : {sgp::TABU_LIST::DOTU, sgp::TABU_LIST::FLAT}){
+		/* 8-4-11 is not solved: every run goes to max_tries */
+		auto whole = sgp::make_tabu_solver(list, 8, 4, 11, 3000, 100, 4, 100);
+		whole->seed(5);
+		whole->run();
+
+		/* stopped half-way, then resumed by a new solver */
+		auto first = sgp::make_tabu_solver(list, 8, 4, 11, 1500, 100, 4, 100);
+		first->seed(5);
+		first->set_checkpoint(path, 400);
+		first->run();
+		auto rest = sgp::make_tabu_solver(list, 8, 4, 11, 3000, 100, 4, 100);
+		rest->seed(9);
+		ASSERT_NO_THROW(rest->resume(path));
+		rest->run();
+
+		EXPECT_EQ(rest->iterations(), whole->iterations());
+		EXPECT_EQ(rest->restarts(), whole->restarts());
+		EXPECT_EQ(rest->get_eval(), whole->get_eval());
+		EXPECT_EQ(	rest->stats().moves_evaluated, 
+					whole->stats().moves_evaluated);
+		EXPECT_EQ(	rest->stats().milestones.size(), 
+					whole->stats().milestones.size());
+		std::ostringstream a, b;
+		whole->print(a);
+		rest->print(b);
+		EXPECT_EQ(a.str(), b.str());
+
+		/* checkpoints of another instance or tabu list */
+		auto other = sgp::make_tabu_solver(list, 8, 4, 10, 3000, 100, 4, 100);
+		EXPECT_THROW(other->resume(path), std::invalid_argument);
+		auto other_list = sgp::make_tabu_solver(
+					list == sgp::TABU_LIST::DOTU ? 
+							sgp::TABU_LIST::FLAT : sgp::TABU_LIST::DOTU,
+					8, 4, 11, 3000, 100, 4, 100);
+		EXPECT_THROW(other_list->resume(path), std::invalid_argument);
+
+		/* or of a search with other options */
+		auto tenures = sgp::make_tabu_solver(list, 8, 4, 11, 3000, 100, 4, 50);
+		EXPECT_THROW(tenures->resume(path), std::invalid_argument);
+		auto stable = sgp::make_tabu_solver(list, 8, 4, 11, 3000, 200, 4, 100);
+		EXPECT_THROW(stable->resume(path), std::invalid_argument);
+		auto greedy = sgp::make_tabu_solver(list, 8, 4, 11, 3000, 100, 4, 100);
+		greedy->set_init_alg(sgp::INIT_ALG::GREEDY);
+		EXPECT_THROW(greedy->resume(path), std::invalid_argument);
+		auto pinned = sgp::make_tabu_solver(list, 8, 4, 11, 3000, 100, 4, 100);
+		pinned->set_symmetry(sgp::SYMMETRY::FIRST_WEEK);
+		EXPECT_THROW(pinned->resume(path), std::invalid_argument);
+	}
+
+	/* files whose best solution or counters were corrupted */
+	sgp::SGP instance(8, 4, 11);
+	sgp::SGPFlatTabuList tabu(instance, 4, 100);
+	auto first = sgp::make_tabu_solver(	sgp::TABU_LIST::FLAT, 8, 4, 11, 
+										1500, 100, 4, 100);
+	first->seed(5);
+	first->set_checkpoint(path, 400);
+	first->run();
+	sgp::TabuCheckpoint saved;
+	saved.g = 8;
+	saved.p = 4;
+	saved.w = 11;
+	saved.init_alg = sgp::INIT_ALG::RANDOM;
+	saved.symmetry = sgp::SYMMETRY::NONE;
+	saved.max_stable = 100;
+	sgp::read_checkpoint(path, saved, tabu);
+	const std::string bad_path = "tabu_resume_bad.ckpt";
+	for(int corruption = 0 ; corruption < 4 ; corruption++){
+		sgp::TabuCheckpoint bad = saved;
+		switch(corruption){
+			case 0: bad.best.tables[1] = bad.best.tables[0]; break;
+			case 1: bad.best.eval = 0; break;
+			case 2: bad.iter_best = bad.current.solution.eval + 1; break;
+			case 3: bad.stable_tries = 102; break;
+		}
+		ASSERT_TRUE(sgp::write_checkpoint(bad_path, bad, tabu));
+		auto rest = sgp::make_tabu_solver(	sgp::TABU_LIST::FLAT, 8, 4, 11, 
+											3000, 100, 4, 100);
+		EXPECT_THROW(rest->resume(bad_path), std::invalid_argument);
+	}
+	ASSERT_TRUE(sgp::write_checkpoint(bad_path, saved, tabu));
+	auto rest = sgp::make_tabu_solver(	sgp::TABU_LIST::FLAT, 8, 4, 11, 
+										3000, 100, 4, 100);
+	EXPECT_NO_THROW(rest->resume(bad_path));
+	std::remove(bad_path.c_str());
+	std::remove(path.c_str());
+
+	auto grasp = sgp::make_grasp_solver(8, 4, 11, 10, 10, 3, 4, 100);
+	EXPECT_THROW(grasp->resume(path), std::invalid_argument);
+	EXPECT_THROW(grasp->set_checkpoint(path, 10), std::invalid_argument);
+}